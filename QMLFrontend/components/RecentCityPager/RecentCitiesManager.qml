@@ -14,6 +14,9 @@ Rectangle {
     
     // UI状态属性
     property int currentIndex: 0
+    // 最近城市列表模型（C++），行数和城市名都直接从模型读取，不再复制整个列表
+    readonly property var citiesModel: weatherViewModel ? weatherViewModel.recentCitiesModel : null
+    readonly property int cityCount: citiesModel ? citiesModel.count : 0
     
     // 信号
     signal cityChanged(string cityName)
@@ -44,16 +47,16 @@ Rectangle {
             width: parent.width - 100
             height: parent.height
             
-            cityName: weatherViewModel && weatherViewModel.currentCityData ? 
-                     weatherViewModel.currentCityData.cityName : ""
-            temperature: weatherViewModel && weatherViewModel.currentCityData ? 
-                        weatherViewModel.currentCityData.temperature : "--°C"
-            weatherIcon: weatherViewModel && weatherViewModel.currentCityData ? 
-                        weatherViewModel.currentCityData.weatherIcon : ""
-            weatherDescription: weatherViewModel && weatherViewModel.currentCityData ? 
-                               weatherViewModel.currentCityData.weatherDescription : "未知"
-            maxMinTemp: weatherViewModel && weatherViewModel.currentCityData ? 
-                       weatherViewModel.currentCityData.maxMinTemp : "--°C / --°C"
+            cityName: weatherViewModel && weatherViewModel.currentWeatherData ? 
+                     weatherViewModel.currentWeatherData.cityName : ""
+            temperature: weatherViewModel && weatherViewModel.currentWeatherData ? 
+                        weatherViewModel.currentWeatherData.temperature : "--°C"
+            weatherIcon: weatherViewModel && weatherViewModel.currentWeatherData ? 
+                        weatherViewModel.currentWeatherData.weatherIcon : ""
+            weatherDescription: weatherViewModel && weatherViewModel.currentWeatherData ? 
+                               weatherViewModel.currentWeatherData.weatherDescription : "未知"
+            maxMinTemp: weatherViewModel && weatherViewModel.currentWeatherData ? 
+                       weatherViewModel.currentWeatherData.maxMinTemp : "--°C / --°C"
         }
         
         // 分页指示器和导航
@@ -66,15 +69,12 @@ Rectangle {
             PageIndicator {
                 id: pageIndicator
                 anchors.horizontalCenter: parent.horizontalCenter
-                totalPages: weatherViewModel ? weatherViewModel.getRecentCities().length : 0
+                totalPages: cityCount
                 currentPage: currentIndex
                 
                 onPageClicked: function(pageIndex) {
-                    if (weatherViewModel && pageIndex < weatherViewModel.getRecentCities().length) {
-                        currentIndex = pageIndex
-                        var cityName = weatherViewModel.getRecentCities()[pageIndex].name
-                        weatherViewModel.switchToCity(pageIndex)
-                        cityChanged(cityName)
+                    if (weatherViewModel && pageIndex < cityCount) {
+                        switchToIndex(pageIndex)
                     }
                 }
             }
@@ -90,7 +90,7 @@ Rectangle {
                     height: 30
                     radius: 15
                     color: "#4A90E2"
-                    visible: weatherViewModel && weatherViewModel.getRecentCities() && weatherViewModel.getRecentCities().length > 1
+                    visible: cityCount > 1
                     
                     Text {
                         anchors.centerIn: parent
@@ -102,15 +102,7 @@ Rectangle {
                     
                     MouseArea {
                         anchors.fill: parent
-                        onClicked: {
-                            if (weatherViewModel && weatherViewModel.recentCities.length > 0) {
-                                var newIndex = (currentIndex - 1 + weatherViewModel.recentCities.length) % weatherViewModel.recentCities.length
-                                currentIndex = newIndex
-                                var cityName = weatherViewModel.recentCities[newIndex].name
-                                weatherViewModel.switchToCity(cityName)
-                                cityChanged(cityName)
-                            }
-                        }
+                        onClicked: switchToPrevious()
                     }
                 }
                 
@@ -120,7 +112,7 @@ Rectangle {
                     height: 30
                     radius: 15
                     color: "#4A90E2"
-                    visible: weatherViewModel && weatherViewModel.recentCities && weatherViewModel.recentCities.length > 1
+                    visible: cityCount > 1
                     
                     Text {
                         anchors.centerIn: parent
@@ -132,70 +124,58 @@ Rectangle {
                     
                     MouseArea {
                         anchors.fill: parent
-                        onClicked: {
-                            if (weatherViewModel && weatherViewModel.getRecentCities().length > 0) {
-                                var newIndex = (currentIndex + 1) % weatherViewModel.getRecentCities().length
-                                currentIndex = newIndex
-                                var cityName = weatherViewModel.getRecentCities()[newIndex].name
-                                weatherViewModel.switchToCity(newIndex)
-                                cityChanged(cityName)
-                            }
-                        }
+                        onClicked: switchToNext()
                     }
                 }
             }
         }
     }
     
-    // 监听最近城市列表变化
+    // 监听最近城市列表的行变化（插入/移动/删除）
     Connections {
-        target: weatherViewModel
-        function onRecentCitiesChanged() {
-            updateCurrentIndex()
-        }
+        target: citiesModel
+        function onRowsInserted() { updateCurrentIndex() }
+        function onRowsMoved() { updateCurrentIndex() }
+        function onRowsRemoved() { updateCurrentIndex() }
     }
     
     // 监听当前城市变化
     Connections {
         target: weatherViewModel
-        function onCurrentCityChanged() {
+        function onCurrentWeatherDataChanged() {
             updateCurrentIndex()
         }
     }
     
-    // 更新当前索引
+    // 更新当前索引：按城市名哈希查找行号
     function updateCurrentIndex() {
-        if (!weatherViewModel || !weatherViewModel.currentCityData) return
+        if (!citiesModel || !weatherViewModel || !weatherViewModel.currentWeatherData) return
         
-        var currentCityName = weatherViewModel.currentCityData.cityName
-        var recentCities = weatherViewModel.getRecentCities()
-        for (var i = 0; i < recentCities.length; i++) {
-            if (recentCities[i].name === currentCityName) {
-                currentIndex = i
-                break
-            }
+        var row = citiesModel.indexOf(weatherViewModel.currentWeatherData.cityName || "")
+        if (row >= 0) {
+            currentIndex = row
         }
     }
     
+    // 切换到指定行的城市
+    function switchToIndex(newIndex) {
+        currentIndex = newIndex
+        var cityName = citiesModel.cityNameAt(newIndex)
+        weatherViewModel.switchToCity(newIndex)
+        cityChanged(cityName)
+    }
+    
     // 切换到下一个城市（键盘导航支持）
     function switchToNext() {
-        if (weatherViewModel && weatherViewModel.getRecentCities().length > 0) {
-            var newIndex = (currentIndex + 1) % weatherViewModel.getRecentCities().length
-            currentIndex = newIndex
-            var cityName = weatherViewModel.getRecentCities()[newIndex].name
-            weatherViewModel.switchToCity(newIndex)
-            cityChanged(cityName)
+        if (weatherViewModel && cityCount > 0) {
+            switchToIndex((currentIndex + 1) % cityCount)
         }
     }
     
     // 切换到上一个城市（键盘导航支持）
     function switchToPrevious() {
-        if (weatherViewModel && weatherViewModel.getRecentCities().length > 0) {
-            var newIndex = (currentIndex - 1 + weatherViewModel.getRecentCities().length) % weatherViewModel.getRecentCities().length
-            currentIndex = newIndex
-            var cityName = weatherViewModel.getRecentCities()[newIndex].name
-            weatherViewModel.switchToCity(newIndex)
-            cityChanged(cityName)
+        if (weatherViewModel && cityCount > 0) {
+            switchToIndex((currentIndex - 1 + cityCount) % cityCount)
         }
     }
     
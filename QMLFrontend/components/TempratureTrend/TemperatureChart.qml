@@ -18,11 +18,11 @@ Rectangle {
     property real calculatedMinTemp: 0
     property real calculatedMaxTemp: 40
     
-    // 图表更新函数
+    // 图表更新函数：参数都是整数温度（C++解析时已提取），这里不做任何字符串处理
     function updateChart(maxTemps, minTemps, labels) {
-        maxTemperatures = maxTemps || [];
-        minTemperatures = minTemps || [];
-        dayLabels = labels || [];
+        maxTemperatures = maxTemps ? Array.from(maxTemps) : [];
+        minTemperatures = minTemps ? Array.from(minTemps) : [];
+        dayLabels = labels ? Array.from(labels) : [];
         
         // 计算温度范围
         if (maxTemperatures.length > 0 && minTemperatures.length > 0) {
@@ -35,58 +35,6 @@ Rectangle {
         canvas.requestPaint();
     }
     
-    // 解析温度数据的辅助函数
-    function parseTemperatureData(temperatureStrings, dayNames) {
-        var maxTemps = [];
-        var minTemps = [];
-        var labels = [];
-        
-        console.log("TemperatureChart: 开始解析温度数据，共", temperatureStrings.length, "条记录");
-        
-        for (var i = 0; i < temperatureStrings.length; i++) {
-            var tempStr = temperatureStrings[i];
-            console.log("TemperatureChart: 解析第", i, "条数据:", tempStr);
-            
-            if (tempStr && typeof tempStr === 'string' && tempStr.includes(" / ")) {
-                var temps = tempStr.split(" / ");
-                if (temps.length >= 2) {
-                    var highTempStr = temps[0].trim();
-                    var lowTempStr = temps[1].trim();
-                    
-                    // 支持多种温度格式："高温 30℃"、"30°C"、"30℃"
-                    var highTemp, lowTemp;
-                    
-                    // 解析高温
-                    if (highTempStr.includes("高温")) {
-                        highTemp = parseInt(highTempStr.replace("高温", "").replace("℃", "").replace("°C", "").trim());
-                    } else {
-                        highTemp = parseInt(highTempStr.replace("℃", "").replace("°C", "").trim());
-                    }
-                    
-                    // 解析低温
-                    if (lowTempStr.includes("低温")) {
-                        lowTemp = parseInt(lowTempStr.replace("低温", "").replace("℃", "").replace("°C", "").trim());
-                    } else {
-                        lowTemp = parseInt(lowTempStr.replace("℃", "").replace("°C", "").trim());
-                    }
-                    
-                    console.log("TemperatureChart: 解析结果 - 高温:", highTemp, "低温:", lowTemp);
-                    
-                    if (!isNaN(highTemp) && !isNaN(lowTemp)) {
-                        maxTemps.push(highTemp);
-                        minTemps.push(lowTemp);
-                        labels.push(dayNames[i] || "Day" + (i + 1));
-                    } else {
-                        console.log("TemperatureChart: 温度解析失败，跳过此条数据");
-                    }
-                }
-            }
-        }
-        
-        console.log("TemperatureChart: 最终解析结果 - 最高温度:", maxTemps, "最低温度:", minTemps, "标签:", labels);
-        updateChart(maxTemps, minTemps, labels);
-    }
-    
     Canvas {
         id: canvas
         anchors.fill: parent
@@ -15,6 +15,11 @@ Rectangle {
     property var recentDaysMaxMinTempreture: []
     property var recentDaysWeatherDescriptionIcon: []
     property string currentCityName: ""
+    // 整数最高/最低温（没有预报模型时使用）
+    property var recentDaysHigh: []
+    property var recentDaysLow: []
+    // C++预报列表模型（角色：dayLabel、high、low、maxMinText、condition、icon…）
+    property var forecastModel: null
 
     // 颜色配置
     property color textColor: "#FFFFFF"
@@ -25,14 +30,34 @@ Rectangle {
         console.log("TempratureTrendItem loaded with", recentDaysName.length, "days of data");
     }
 
-    // 监听数据变化，自动更新图表
-    onRecentDaysMaxMinTempretureChanged: {
-        console.log("温度数据已更新，包含", recentDaysMaxMinTempreture.length, "天的数据");
-        if (recentDaysMaxMinTempreture.length > 0) {
-            temperatureChart.parseTemperatureData(recentDaysMaxMinTempreture, recentDaysName);
+    // 把整数温度交给图表：优先使用预报模型，否则使用数值数组
+    function refreshChart() {
+        if (forecastModel) {
+            temperatureChart.updateChart(forecastModel.highs, forecastModel.lows, forecastModel.dayLabels);
+            return;
         }
+        var highs = [];
+        var lows = [];
+        var labels = [];
+        for (var i = 0; i < recentDaysHigh.length && i < recentDaysLow.length; i++) {
+            if (recentDaysHigh[i] === undefined || recentDaysHigh[i] === null) continue;
+            highs.push(recentDaysHigh[i]);
+            lows.push(recentDaysLow[i]);
+            labels.push(recentDaysName[i] || "");
+        }
+        temperatureChart.updateChart(highs, lows, labels);
     }
 
+    // 只在温度真正变化时重绘
+    Connections {
+        target: tempratureTrendItem.forecastModel
+        function onTemperaturesChanged() {
+            tempratureTrendItem.refreshChart();
+        }
+    }
+    onForecastModelChanged: refreshChart()
+    onRecentDaysHighChanged: if (!forecastModel) refreshChart()
+
     // 主要内容布局
     Column {
         width: parent.width - 40
@@ -69,14 +94,18 @@ Rectangle {
                     id: leftListView
                     anchors.fill: parent
                     anchors.margins: 10
-                    model: tempratureTrendItem.recentDaysName.length
+                    model: tempratureTrendItem.forecastModel
                     spacing: 5
+                    // 每行直接绑定模型角色，数据变化时只刷新对应的行
                     delegate: TempratureTrendItemDelegate {
+                        required property string dayLabel
+                        required property string maxMinText
+                        required property string icon
                         width: leftListView.width
                         height: 60
-                        cityName: tempratureTrendItem.recentDaysName[index] || ""
-                        maxMinTempreture: tempratureTrendItem.recentDaysMaxMinTempreture[index] || ""
-                        weatherDescriptionIcon: tempratureTrendItem.recentDaysWeatherDescriptionIcon[index] || ""
+                        cityName: dayLabel
+                        maxMinTempreture: maxMinText
+                        weatherDescriptionIcon: icon
                     }
                 }
             }
@@ -102,12 +131,7 @@ Rectangle {
                     minTempColor: tempratureTrendItem.minTempretureColor
                     textColor: tempratureTrendItem.textColor
                     
-                    Component.onCompleted: {
-                        // 初始化时解析数据
-                        if (recentDaysMaxMinTempreture.length > 0) {
-                            parseTemperatureData(recentDaysMaxMinTempreture, recentDaysName);
-                        }
-                    }
+                    Component.onCompleted: tempratureTrendItem.refreshChart()
                 }
             }
         }
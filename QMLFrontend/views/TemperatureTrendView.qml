@@ -17,12 +17,17 @@ BaseView {
         
         // 绑定数据
         currentCityName: temperatureTrendView.weatherData ? temperatureTrendView.weatherData.cityName : "暂无城市"
+        forecastModel: temperatureTrendView.viewModel ? temperatureTrendView.viewModel.forecastModel : null
         recentDaysName: temperatureTrendView.weatherData && temperatureTrendView.weatherData.weeklyForecast ? 
                        temperatureTrendView.weatherData.weeklyForecast.recentDaysName : []
         recentDaysMaxMinTempreture: temperatureTrendView.weatherData && temperatureTrendView.weatherData.weeklyForecast ? 
                                    temperatureTrendView.weatherData.weeklyForecast.recentDaysMaxMinTempreture : []
         recentDaysWeatherDescriptionIcon: temperatureTrendView.weatherData && temperatureTrendView.weatherData.weeklyForecast ? 
                                          temperatureTrendView.weatherData.weeklyForecast.recentDaysWeatherDescriptionIcon : []
+        recentDaysHigh: temperatureTrendView.weatherData && temperatureTrendView.weatherData.weeklyForecast && temperatureTrendView.weatherData.weeklyForecast.recentDaysHigh ?
+                        temperatureTrendView.weatherData.weeklyForecast.recentDaysHigh : []
+        recentDaysLow: temperatureTrendView.weatherData && temperatureTrendView.weatherData.weeklyForecast && temperatureTrendView.weatherData.weeklyForecast.recentDaysLow ?
+                       temperatureTrendView.weatherData.weeklyForecast.recentDaysLow : []
     }
     
     // 重写数据更新函数
@@ -0,0 +1,55 @@
+#ifndef CITYWEATHERBUNDLE_HPP
+#define CITYWEATHERBUNDLE_HPP
+
+#include <QString>
+#include <QVariantMap>
+#include <QVariantList>
+#include <QJsonObject>
+#include <memory>
+#include "WeatherTypes.hpp"
+
+class CityWeatherBundle;
+using CityWeatherBundlePtr = std::shared_ptr<const CityWeatherBundle>;
+
+// 单次HTTP响应解析得到的城市天气数据包
+// 解析只做一次，得到类型化的当前天气和预报；各视图需要的QVariantMap只在交给QML时按需投影
+class CityWeatherBundle
+{
+public:
+    // 从接口返回的完整JSON（含data/cityInfo）构建数据包
+    static CityWeatherBundlePtr fromJson(const QJsonObject &json);
+    // 由已解析的类型化数据构建数据包（例如从启动快照恢复）
+    static CityWeatherBundlePtr fromConditions(const CurrentConditions &conditions);
+
+    // 根据天气类型返回对应的图标
+    static QString iconForType(const QString &type);
+
+    // 城市名称
+    QString cityName() const { return m_current.cityName; }
+    // 当前天气（含预报列表）
+    const CurrentConditions &current() const { return m_current; }
+    // 预报列表（每天一项，第一项为今天）
+    const QList<DailyForecast> &days() const { return m_current.forecast; }
+
+    // 以下为QML边界使用的投影，每次调用都会新建QVariantMap
+    // 今日天气视图数据
+    QVariantMap currentWeather() const { return m_current.toVariantMap(); }
+    // 温度趋势视图数据（recentDays*数组 + forecast列表）
+    QVariantMap weeklyForecast() const;
+    // 详细信息视图数据
+    QVariantMap detailedInfo() const;
+    // 日出日落视图数据
+    QVariantMap sunriseInfo() const;
+    // 预报原始列表（每天一项）
+    QVariantList forecast() const { return forecastToVariantList(m_current.forecast); }
+
+    // 温度趋势视图最多展示的天数
+    static constexpr int kTrendDays = 7;
+
+private:
+    CityWeatherBundle() = default;
+
+    CurrentConditions m_current;
+};
+
+#endif // CITYWEATHERBUNDLE_HPP
@@ -7,6 +7,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <memory>
+#include "WeatherTypes.hpp"
 
 class WeatherDataModel : public QObject {
     Q_OBJECT
@@ -16,6 +17,10 @@ class WeatherDataModel : public QObject {
     Q_PROPERTY(QString weatherIcon READ weatherIcon WRITE setWeatherIcon NOTIFY weatherIconChanged)
     Q_PROPERTY(QString weatherDescription READ weatherDescription WRITE setWeatherDescription NOTIFY weatherDescriptionChanged)
     Q_PROPERTY(QString maxMinTemp READ maxMinTemp WRITE setMaxMinTemp NOTIFY maxMinTempChanged)
+    // 今天的最高/最低温（℃，整数），解析时提取，界面无需再处理字符串
+    Q_PROPERTY(int highTemperature READ highTemperature NOTIFY highTemperatureChanged)
+    Q_PROPERTY(int lowTemperature READ lowTemperature NOTIFY lowTemperatureChanged)
+    Q_PROPERTY(bool hasTemperatureRange READ hasTemperatureRange NOTIFY hasTemperatureRangeChanged)
     //其余三个功能页面
     Q_PROPERTY(QVariantMap weeklyForecast READ weeklyForecast WRITE setWeeklyForecast NOTIFY weeklyForecastChanged)
     Q_PROPERTY(QVariantMap detailedInfo READ detailedInfo WRITE setDetailedInfo NOTIFY detailedInfoChanged)
@@ -39,6 +44,12 @@ public:
     QString weatherDescription() const { return m_weatherDescription; }
     // 获取最高最低温度
     QString maxMinTemp() const { return m_maxMinTemp; }
+    // 获取今天的最高温
+    int highTemperature() const { return m_highTemperature; }
+    // 获取今天的最低温
+    int lowTemperature() const { return m_lowTemperature; }
+    // 最高/最低温是否有效
+    bool hasTemperatureRange() const { return m_hasTemperatureRange; }
     // 获取每周天气预报信息
     QVariantMap weeklyForecast() const { return m_weeklyForecast; }
     // 获取详细天气信息
@@ -74,8 +85,10 @@ public:
 
 //Static Factory Method 
 
-// 根据原始数据创建 WeatherDataModel 实例
+// 根据原始数据创建 WeatherDataModel 实例（每次都新建对象，长期刷新的场景应复用实例并调用updateData）
 Q_INVOKABLE static WeatherDataModel* fromRawData(const QVariantMap& rawData , QObject *parent = nullptr);
+// 根据类型化的当前天气创建 WeatherDataModel 实例（不经过QVariantMap）
+static WeatherDataModel* fromConditions(const CurrentConditions &conditions, QObject *parent = nullptr);
 // 创建一个空的 WeatherDataModel 实例
 Q_INVOKABLE static WeatherDataModel* createEmpty(QObject *parent = nullptr);
 
@@ -90,6 +103,8 @@ Q_INVOKABLE QVariantMap toObject() const;
 Q_INVOKABLE WeatherDataModel* clone(QObject * parent = nullptr)const;
 // 使用新的数据更新当前的天气数据模型
 Q_INVOKABLE void updateData(const QVariantMap &newData);
+// 使用类型化的当前天气就地更新，只有值发生变化的属性才发出通知；返回是否有属性变化
+bool updateData(const CurrentConditions &conditions);
 
 signals:
     void cityNameChanged();
@@ -97,6 +112,9 @@ signals:
     void weatherIconChanged();
     void weatherDescriptionChanged();
     void maxMinTempChanged();
+    void highTemperatureChanged();
+    void lowTemperatureChanged();
+    void hasTemperatureRangeChanged();
     void weeklyForecastChanged();
     void detailedInfoChanged();
     void sunriseInfoChanged();
@@ -104,11 +122,26 @@ signals:
     void noticeChanged();
 
 private:
+    // 值不同时赋值并发出通知，返回是否发生变化
+    template <typename T>
+    bool assign(T &member, const T &value, void (WeatherDataModel::*notify)())
+    {
+        if (member == value) {
+            return false;
+        }
+        member = value;
+        emit (this->*notify)();
+        return true;
+    }
+
     QString m_cityName;
     QString m_temperature;
     QString m_weatherIcon;
     QString m_weatherDescription;
     QString m_maxMinTemp;
+    int m_highTemperature;
+    int m_lowTemperature;
+    bool m_hasTemperatureRange;
     QVariantMap m_weeklyForecast;
     QVariantMap m_detailedInfo;
     QVariantMap m_sunriseInfo;
@@ -0,0 +1,164 @@
+#ifndef WEATHERTYPES_HPP
+#define WEATHERTYPES_HPP
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QVariantMap>
+#include <QMetaType>
+#include <QtNumeric>
+
+class QDataStream;
+
+// 天气数据的值类型：解析时一次性填好，之后在各层之间按值（隐式共享）传递
+// 都是Q_GADGET，QML可以直接读取属性；需要QVariantMap时只在QML边界调用toVariantMap转换一次
+
+// 单日预报
+class DailyForecast
+{
+    Q_GADGET
+    Q_PROPERTY(QString date MEMBER date)
+    Q_PROPERTY(QString week MEMBER week)
+    Q_PROPERTY(QString high MEMBER high)
+    Q_PROPERTY(QString low MEMBER low)
+    Q_PROPERTY(int highTemp MEMBER highTemp)
+    Q_PROPERTY(int lowTemp MEMBER lowTemp)
+    Q_PROPERTY(bool hasTemperature MEMBER hasTemperature)
+    Q_PROPERTY(QString type MEMBER type)
+    Q_PROPERTY(QString icon MEMBER icon)
+    Q_PROPERTY(QString windDirection MEMBER windDirection)
+    Q_PROPERTY(QString windPower MEMBER windPower)
+    Q_PROPERTY(QString sunrise MEMBER sunrise)
+    Q_PROPERTY(QString sunset MEMBER sunset)
+    Q_PROPERTY(QString notice MEMBER notice)
+
+public:
+    QString date;          // 日期（yyyy-MM-dd）
+    QString week;          // 星期
+    QString high;          // 最高温原文（如"高温 30℃"）
+    QString low;           // 最低温原文（如"低温 20℃"）
+    int highTemp = 0;      // 最高温（℃），解析时从high提取
+    int lowTemp = 0;       // 最低温（℃），解析时从low提取
+    bool hasTemperature = false; // highTemp/lowTemp是否有效
+    QString type;          // 天气类型（晴、多云…）
+    QString icon;          // 天气图标
+    QString windDirection; // 风向
+    QString windPower;     // 风力
+    QString sunrise;       // 日出时间（HH:mm）
+    QString sunset;        // 日落时间（HH:mm）
+    QString notice;        // 提示语
+
+    // "高温 30℃ / 低温 20℃"
+    QString maxMinText() const { return high + " / " + low; }
+
+    // 从"高温 30℃"、"低温 -5℃"这类文本中提取带符号的整数温度，失败返回false
+    static bool temperatureFromText(QStringView text, int *value);
+
+    // 转换为 {date, week, high, low, highTemp, lowTemp, type, icon}
+    QVariantMap toVariantMap() const;
+};
+
+// 详细信息（湿度、风、空气质量等）
+class WeatherDetails
+{
+    Q_GADGET
+    Q_PROPERTY(int humidity MEMBER humidity)
+    Q_PROPERTY(double pm25 MEMBER pm25)
+    Q_PROPERTY(QString airQuality MEMBER airQuality)
+    Q_PROPERTY(QString windDirection MEMBER windDirection)
+    Q_PROPERTY(QString windPower MEMBER windPower)
+    Q_PROPERTY(QString uvIndex MEMBER uvIndex)
+
+public:
+    int humidity = -1;     // 相对湿度（百分比），未知为-1
+    double pm25 = -1;      // PM2.5（μg/m³），未知为-1
+    QString airQuality;    // 空气质量（优、良…）
+    QString windDirection; // 风向
+    QString windPower;     // 风力
+    QString uvIndex;       // 紫外线强度
+
+    // 转换为详细信息视图使用的 {humidity, windSpeed, rainfall, airQuality, airPressure, uvIndex}
+    QVariantMap toVariantMap() const;
+};
+
+// 日出日落
+class SunTimes
+{
+    Q_GADGET
+    Q_PROPERTY(QString sunrise MEMBER sunrise)
+    Q_PROPERTY(QString sunset MEMBER sunset)
+    Q_PROPERTY(int sunriseMinutes MEMBER sunriseMinutes)
+    Q_PROPERTY(int sunsetMinutes MEMBER sunsetMinutes)
+    Q_PROPERTY(int timezone MEMBER timezone)
+
+public:
+    QString sunrise;         // 日出时间（HH:mm）
+    QString sunset;          // 日落时间（HH:mm）
+    int sunriseMinutes = -1; // 日出时刻距零点的分钟数，未知为-1
+    int sunsetMinutes = -1;  // 日落时刻距零点的分钟数，未知为-1
+    int timezone = 0;        // 时区偏移（秒）
+
+    // 由"HH:mm"文本填充，同时计算分钟数
+    static SunTimes fromText(const QString &sunrise, const QString &sunset);
+
+    // 转换为 {sunrise, sunset, timezone}
+    QVariantMap toVariantMap() const;
+};
+
+// 当前天气（含今天及之后几天的预报）
+class CurrentConditions
+{
+    Q_GADGET
+    Q_PROPERTY(QString cityName MEMBER cityName)
+    Q_PROPERTY(double temperature MEMBER temperature)
+    Q_PROPERTY(QString type MEMBER type)
+    Q_PROPERTY(QString icon MEMBER icon)
+    Q_PROPERTY(QString ganmao MEMBER ganmao)
+    Q_PROPERTY(QString notice MEMBER notice)
+    Q_PROPERTY(WeatherDetails details MEMBER details)
+    Q_PROPERTY(SunTimes sun MEMBER sun)
+    Q_PROPERTY(QList<DailyForecast> forecast MEMBER forecast)
+    Q_PROPERTY(QString temperatureText READ temperatureText)
+    Q_PROPERTY(QString maxMinTemp READ maxMinTemp)
+
+public:
+    QString cityName;
+    double temperature = qQNaN(); // 当前温度（℃），未知为NaN
+    QString type;                 // 天气类型
+    QString icon;                 // 天气图标
+    QString ganmao;               // 感冒指数
+    QString notice;               // 提示语
+    WeatherDetails details;
+    SunTimes sun;
+    QList<DailyForecast> forecast; // 第一项为今天
+
+    bool isValid() const { return !cityName.isEmpty() && !qIsNaN(temperature); }
+
+    // "25°C"，未知时为"--°C"
+    QString temperatureText() const;
+    // 今天的"高温 / 低温"
+    QString maxMinTemp() const;
+
+    // 转换为今日天气视图使用的完整数据（含detailedInfo、sunriseInfo和weeklyForecast列表）
+    QVariantMap toVariantMap() const;
+};
+
+// 预报列表转换为 [{date, week, high, low, highTemp, lowTemp, type, icon}, …]
+QVariantList forecastToVariantList(const QList<DailyForecast> &days);
+
+// 二进制序列化（启动快照使用），字段顺序变化时需提升快照文件版本
+QDataStream &operator<<(QDataStream &out, const DailyForecast &day);
+QDataStream &operator>>(QDataStream &in, DailyForecast &day);
+QDataStream &operator<<(QDataStream &out, const WeatherDetails &details);
+QDataStream &operator>>(QDataStream &in, WeatherDetails &details);
+QDataStream &operator<<(QDataStream &out, const SunTimes &sun);
+QDataStream &operator>>(QDataStream &in, SunTimes &sun);
+QDataStream &operator<<(QDataStream &out, const CurrentConditions &conditions);
+QDataStream &operator>>(QDataStream &in, CurrentConditions &conditions);
+
+Q_DECLARE_METATYPE(DailyForecast)
+Q_DECLARE_METATYPE(WeatherDetails)
+Q_DECLARE_METATYPE(SunTimes)
+Q_DECLARE_METATYPE(CurrentConditions)
+
+#endif // WEATHERTYPES_HPP
@@ -5,9 +5,18 @@
 #include <QVariantMap>
 #include <QString>
 #include <QVariantList>
+#include <QHash>
+#include <QTimer>
 #include <QQmlEngine>
 #include <QtQml>
 #include <memory>
+#include "../commonDataType/WeatherTypes.hpp"
+#include "RecentCitiesModel.hpp"
+#include "WeatherSnapshotStore.hpp"
+#include "../services/WeatherRequest.hpp"
+#include "../services/WeatherDataBus.hpp"
+
+class WeatherPrefetcher;
 
 class WeatherDataService;
 
@@ -20,6 +29,8 @@ class AppStateManager : public QObject{
     Q_PROPERTY(QString currentViewMode READ currentViewMode NOTIFY currentViewModeChanged)
     // 定义最近城市的列表属性，只读并且在更改时发出通知
     Q_PROPERTY(QVariantList recentCities READ recentCities NOTIFY recentCitiesChanged)
+    // 最近城市列表模型，按行通知插入/移动/删除
+    Q_PROPERTY(RecentCitiesModel* recentCitiesModel READ recentCitiesModel CONSTANT)
     // 定义当前城市索引的属性，只读并且在更改时发出通知
     Q_PROPERTY(int currentCityIndex READ currentCityIndex NOTIFY currentCityIndexChanged)
     // 定义最大城市数的属性，可读写并且在更改时发出通知
@@ -36,14 +47,20 @@ public:
     QVariantMap currentCity() const { return m_currentCity; }
     // 返回当前视图模式
     QString currentViewMode() const { return m_currentViewMode; }
-    // 返回最近访问的城市列表
-    QVariantList recentCities() const { return m_recentCities; }
+    // 返回最近访问的城市列表（每次调用都会复制，QML应优先使用recentCitiesModel）
+    QVariantList recentCities() const { return m_recentCities->toVariantList(); }
+    // 返回最近访问的城市列表模型
+    RecentCitiesModel *recentCitiesModel() const { return m_recentCities; }
     // 返回当前城市在最近访问城市列表中的索引
     int currentCityIndex() const { return m_currentCityIndex; }
     // 返回允许保存的最大城市数量
     int maxCities() const { return m_maxCities; }
-    // 返回当前城市的天气数据
-    QVariantMap weatherData() const { return m_weatherData; }
+    // 返回当前城市的天气数据（QML边界：由类型化数据转换，转换结果缓存到下次更新）
+    QVariantMap weatherData() const;
+    // 返回当前城市的类型化天气数据
+    const CurrentConditions &currentConditions() const { return m_conditions; }
+    // 返回当前城市的类型化预报
+    const QList<DailyForecast> &forecastDays() const { return m_forecastDays; }
 
     // 设置允许的最大城市数量
     void setMaxCities(int maxCities);
@@ -62,9 +79,9 @@ public:
     Q_INVOKABLE void switchToNext();
     // 切换到上一个城市
     Q_INVOKABLE void switchToPrevious();
-    // 获取当前城市的视图数据
+    // 获取当前城市的视图数据（从快照同步返回，快照过期时在后台刷新，刷新完成后发出citychanged）
     Q_INVOKABLE QVariantMap getCurrentCityForView();
-    // 获取指定城市的周天气预报
+    // 获取指定城市的周天气预报（同上，没有快照时只返回cityName/requestType）
     Q_INVOKABLE QVariantMap getWeeklyForecast(const QString &cityName);
     // 获取指定城市的详细信息
     Q_INVOKABLE QVariantMap getDetailedInfo(const QString &cityName);
@@ -72,6 +89,8 @@ public:
     Q_INVOKABLE QVariantMap getSunriseInfo(const QString &cityName);
     // 加载示例数据
     Q_INVOKABLE void loadSampleData();
+    // 提示下一个可能打开的视图，空闲时为当前及相邻城市预先生成该视图的数据
+    Q_INVOKABLE void prefetchView(const QString &viewMode);
 
 signals:
     // 当当前城市发生变化时发出通知
@@ -98,8 +117,7 @@ signals:
     void weatherDataUpdated(const QVariantMap &data);
 
 private slots:
-    // 处理WeatherDataService的信号
-    void onWeatherDataLoaded(const QVariantMap &data);
+    // 当前城市加载失败（且没有可显示的快照）
     void onWeatherDataError(const QString &error);
 
 private:
@@ -107,15 +125,52 @@ private:
     bool m_initialized;
     QVariantMap m_currentCity;
     QString m_currentViewMode;
-    QVariantList m_recentCities;
+    RecentCitiesModel *m_recentCities;
     int m_currentCityIndex;
     int m_maxCities;
-    QVariantMap m_weatherData;
+    // 天气数据以类型化形式保存，QVariantMap只在QML读取时生成
+    bool m_hasWeatherData;
+    CurrentConditions m_conditions;
+    QList<DailyForecast> m_forecastDays;
+    QString m_weatherError;
+    mutable QVariantMap m_weatherDataCache;
+    mutable bool m_weatherDataCacheValid;
+    // 按城市、按视图保存的快照，视图切换不再发起网络请求
+    WeatherSnapshotStore m_snapshots;
+    // 进行中的前台刷新（城市名 -> 请求标识），离开该城市附近时取消
+    QHash<QString, WeatherRequestId> m_refreshRequests;
+    // 当前城市在数据总线上的订阅
+    QString m_subscribedCity;
+    WeatherDataBus::SubscriptionId m_cityBundleSubscription;
+    WeatherDataBus::SubscriptionId m_cityErrorSubscription;
     
+    // 启动快照：状态变化后延迟写入，启动时先用它绘制界面
+    QTimer m_saveTimer;
+
     std::unique_ptr<WeatherDataService> m_weatherService;
+    // 相邻城市的低优先级预取（子对象）
+    WeatherPrefetcher *m_prefetcher;
     
     void setCurrentCityInternal(const QVariantMap &cityData);
+    // 改为订阅cityName的数据（退订之前的城市）
+    void subscribeToCity(const QString &cityName);
+    // 当前城市收到新数据包：写入快照、更新类型化状态并推送给视图
+    void applyCurrentBundle(const QString &cityName, const CityWeatherBundlePtr &bundle);
     void setCurrentCityIndex(int index);
+    // 类型化天气数据变化后使QML缓存失效并发出通知
+    void notifyWeatherDataChanged();
+    // 城市快照缺失或过期时在后台刷新（同一城市同时只有一个请求）
+    void refreshSnapshotIfStale(const QString &cityName);
+    // 从快照读取某个视图的数据，必要时触发后台刷新
+    QVariantMap snapshotView(const QString &cityName, const QString &viewMode, const QString &requestType);
+    // 把当前城市及前后相邻城市交给预取器
+    void schedulePrefetch();
+    // 从启动快照恢复最近城市、视图模式和天气数据，没有可用快照时返回false
+    bool restoreWarmStart();
+    // 写入启动快照
+    void saveWarmStart();
+    // 状态变化后安排写入（合并短时间内的多次变化）
+    void scheduleWarmStartSave();
 
 };
 
@@ -0,0 +1,97 @@
+#ifndef FORECASTLISTMODEL_HPP
+#define FORECASTLISTMODEL_HPP
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QStringList>
+#include "../commonDataType/WeatherTypes.hpp"
+
+// 多日预报列表模型：每天一行，角色都是类型化的值
+// 刷新时逐行比较，只对变化的行和角色发出dataChanged，行数变化时在末尾插入/删除
+class ForecastListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    // 图表使用的整数温度和标签（只含温度有效的行），任一行温度或标签变化时通知
+    Q_PROPERTY(QList<int> highs READ highs NOTIFY temperaturesChanged)
+    Q_PROPERTY(QList<int> lows READ lows NOTIFY temperaturesChanged)
+    Q_PROPERTY(QStringList dayLabels READ dayLabels NOTIFY temperaturesChanged)
+
+public:
+    // 天气状况分类，供委托选择图标、配色
+    enum Condition {
+        Unknown = 0,
+        Sunny,
+        Cloudy,
+        Overcast,
+        Rain,
+        Snow,
+        Fog,
+        Thunder
+    };
+    Q_ENUM(Condition)
+
+    enum Roles {
+        DateRole = Qt::UserRole + 1, // 日期（yyyy-MM-dd）
+        WeekdayRole,                 // 星期
+        DayLabelRole,                // 显示用标签（今天、明天、星期X）
+        HighRole,                    // 最高温（℃，整数）
+        LowRole,                     // 最低温（℃，整数）
+        HasTemperatureRole,          // 最高/最低温是否有效
+        MaxMinTextRole,              // "高温 30℃ / 低温 20℃"
+        TypeRole,                    // 天气类型原文
+        ConditionRole,               // 天气状况分类（Condition）
+        IconRole                     // 天气图标
+    };
+    Q_ENUM(Roles)
+
+    // 最多展示的天数
+    static constexpr int kMaxDays = 7;
+
+    explicit ForecastListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QList<int> highs() const;
+    QList<int> lows() const;
+    QStringList dayLabels() const;
+
+    // 用新的预报替换当前内容（超过kMaxDays的部分忽略）
+    void setForecast(const QList<DailyForecast> &days);
+    // 清空
+    void clear();
+
+    // 根据天气类型文本归类
+    static Condition conditionForType(const QString &type);
+
+signals:
+    void countChanged();
+    void temperaturesChanged();
+
+private:
+    // 一行的类型化数据
+    struct Row {
+        QString date;
+        QString weekday;
+        QString dayLabel;
+        int high = 0;
+        int low = 0;
+        bool hasTemperature = false;
+        QString maxMinText;
+        QString type;
+        Condition condition = Unknown;
+        QString icon;
+    };
+
+    static Row makeRow(const DailyForecast &day, qsizetype index);
+    // 两行之间发生变化的角色
+    static QList<int> changedRoles(const Row &before, const Row &after);
+
+    QList<Row> m_rows;
+};
+
+#endif // FORECASTLISTMODEL_HPP
@@ -0,0 +1,65 @@
+#ifndef RECENTCITIESMODEL_HPP
+#define RECENTCITIESMODEL_HPP
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QVariantMap>
+#include <QVariantList>
+
+// 最近访问城市列表模型：连续存储的行 + 城市名到行号的哈希
+// 访问城市时移动/插入到第一行，超出上限时从末尾删除，都通过行级信号通知，视图不必重新读取整个列表
+class RecentCitiesModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        CityNameRole = Qt::UserRole + 1, // 城市名称
+        CityDataRole                     // 添加时传入的完整城市数据
+    };
+    Q_ENUM(Roles)
+
+    explicit RecentCitiesModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // 城市所在的行，不存在返回-1
+    Q_INVOKABLE int indexOf(const QString &cityName) const;
+    // 指定行的城市名称，越界返回空字符串
+    Q_INVOKABLE QString cityNameAt(int row) const;
+    // 指定行的城市数据，越界返回空表
+    Q_INVOKABLE QVariantMap cityAt(int row) const;
+
+    // 把城市放到第一行：已存在则移动（并更新数据），否则插入；随后裁剪到maxCount行
+    void touch(const QString &cityName, const QVariantMap &cityData, int maxCount);
+    // 只保留前maxCount行
+    void truncate(int maxCount);
+    // 清空
+    void clear();
+    // 转换为列表（兼容旧的QVariantList接口）
+    QVariantList toVariantList() const;
+
+signals:
+    void countChanged();
+
+private:
+    struct City {
+        QString name;
+        QVariantMap data;
+    };
+
+    // 重新登记[first, last]范围内各行的行号
+    void reindex(qsizetype first, qsizetype last);
+    // 删除第maxCount行之后的行（不发countChanged），返回是否删除了行
+    bool removeTail(int maxCount);
+
+    QList<City> m_cities;
+    QHash<QString, qsizetype> m_rowByName;
+};
+
+#endif // RECENTCITIESMODEL_HPP
@@ -0,0 +1,45 @@
+#ifndef WARMSTARTFILE_HPP
+#define WARMSTARTFILE_HPP
+
+#include <QString>
+#include <QList>
+#include <QVariantMap>
+#include "../commonDataType/WeatherTypes.hpp"
+
+// 启动快照的内容：最近城市、当前索引、视图模式和每个城市最后一次的天气数据
+struct WarmStartState
+{
+    struct City {
+        QString name;
+        QVariantMap data;
+    };
+    struct Snapshot {
+        QString cityName;        // 最近城市列表中的名字（快照存储的键）
+        CurrentConditions conditions;
+        qint64 fetchedAtMs = 0;  // 数据获取时刻（自纪元起的毫秒）
+    };
+
+    QString viewMode;
+    int currentIndex = 0;
+    QList<City> cities;
+    QList<Snapshot> snapshots;
+};
+
+// 带版本号的二进制启动快照文件
+// 写入使用QSaveFile整体替换，中途失败不会留下半个文件；读取时映射整个文件，不额外复制一份
+class WarmStartFile
+{
+public:
+    // 文件头："WSNP" + 版本号，格式变化时提升版本，旧文件直接忽略
+    static constexpr quint32 kMagic = 0x57534E50;
+    static constexpr quint16 kVersion = 1;
+
+    // 默认路径：应用数据目录下的warmstart.bin
+    static QString defaultPath();
+
+    static bool save(const QString &path, const WarmStartState &state);
+    // 文件不存在、版本不符或内容损坏时返回false，state不变
+    static bool load(const QString &path, WarmStartState *state);
+};
+
+#endif // WARMSTARTFILE_HPP
@@ -0,0 +1,64 @@
+#ifndef WEATHERPREFETCHER_HPP
+#define WEATHERPREFETCHER_HPP
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QTimer>
+#include "../commonDataType/CityWeatherBundle.hpp"
+#include "../services/WeatherRequest.hpp"
+
+class WeatherSnapshotStore;
+class WeatherDataService;
+
+// 低优先级预取：在用户停下后为相邻城市预热快照，并提前生成下一个视图的数据
+// 同时进行的请求数受预算限制；目标变化时丢弃尚未发出的请求，并取消不再是目标的进行中请求
+class WeatherPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // store/service由调用方持有，生命周期需覆盖本对象
+    WeatherPrefetcher(WeatherSnapshotStore *store, WeatherDataService *service, QObject *parent = nullptr);
+
+    // 设置预取目标（按优先级排列）和可能的下一个视图，等待空闲后开始
+    void setTargets(const QStringList &cityNames, const QString &likelyView = QString());
+    // 只更新可能的下一个视图，并为已有快照的目标城市预热该视图
+    void setLikelyView(const QString &viewMode);
+    // 取消所有预取（包括进行中的请求）
+    void cancel();
+
+    // 同时进行的预取请求上限
+    void setMaxInFlight(int maxInFlight) { m_maxInFlight = qMax(1, maxInFlight); }
+    int maxInFlight() const { return m_maxInFlight; }
+    // 目标设置后等待多久才开始（连续翻页时只预取最后停下的位置）
+    void setIdleDelay(int delayMs) { m_idleTimer.setInterval(delayMs); }
+
+    static constexpr int kDefaultMaxInFlight = 2;
+    static constexpr int kDefaultIdleDelayMs = 300;
+
+signals:
+    // 某个城市的快照已由预取更新
+    void snapshotUpdated(const QString &cityName);
+
+private:
+    // 在预算内发出排队中的请求
+    void pump();
+    void fetch(const QString &cityName);
+    // 取消一个进行中的预取并释放该城市的刷新标记
+    void abort(const QString &cityName);
+    // 为城市生成可能的下一个视图的数据
+    void warmView(const QString &cityName);
+
+    WeatherSnapshotStore *m_store;
+    WeatherDataService *m_service;
+    QStringList m_queue;
+    // 进行中的预取（城市名 -> 请求标识）
+    QHash<QString, WeatherRequestId> m_inFlight;
+    QString m_likelyView;
+    int m_maxInFlight;
+    QTimer m_idleTimer;
+};
+
+#endif // WEATHERPREFETCHER_HPP
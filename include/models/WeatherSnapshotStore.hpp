@@ -0,0 +1,70 @@
+#ifndef WEATHERSNAPSHOTSTORE_HPP
+#define WEATHERSNAPSHOTSTORE_HPP
+
+#include <QCache>
+#include <QHash>
+#include <QString>
+#include <QVariantMap>
+#include <QDeadlineTimer>
+#include "../commonDataType/CityWeatherBundle.hpp"
+
+// 按城市、按视图保存的天气快照：切换视图/城市时直接从内存同步返回
+// 与响应缓存不同，过期的快照仍然可读（先显示旧数据），由调用方在后台刷新
+class WeatherSnapshotStore
+{
+public:
+    // 视图标识，与AppStateManager的视图模式一致
+    static constexpr const char *kTodayView = "today_weather";
+    static constexpr const char *kTrendView = "temperature_trend";
+    static constexpr const char *kDetailView = "detailed_info";
+    static constexpr const char *kSunriseView = "sunrise_sunset";
+
+    // maxCities: 最多保留的城市数（LRU淘汰），freshMs: 快照保持新鲜的时间
+    explicit WeatherSnapshotStore(int maxCities = 32, int freshMs = 10 * 60 * 1000);
+
+    // 保存城市的最新数据包，清除该城市已生成的视图投影（与已有的是同一个数据包时不变）
+    // fetchedAtMs为数据获取时刻（自纪元起的毫秒），-1表示现在；新鲜期从获取时刻算起
+    void insert(const QString &cityName, const CityWeatherBundlePtr &bundle, qint64 fetchedAtMs = -1);
+    // 城市的数据包（可能已过期），没有时返回空指针
+    CityWeatherBundlePtr bundle(const QString &cityName) const;
+    // 数据包的获取时刻（自纪元起的毫秒），没有快照时返回-1
+    qint64 fetchedAt(const QString &cityName) const;
+    // 是否有该城市的快照
+    bool contains(const QString &cityName) const { return m_entries.contains(cityName); }
+    // 快照是否仍在新鲜期内
+    bool isFresh(const QString &cityName) const;
+
+    // 城市在某个视图下的数据，首次读取时生成并缓存；没有快照时返回空表
+    QVariantMap view(const QString &cityName, const QString &viewMode);
+
+    // 标记开始刷新，已有刷新在进行时返回false（同一城市只发起一次）
+    bool beginRefresh(const QString &cityName);
+    // 刷新结束（成功时应先调用insert）
+    void endRefresh(const QString &cityName);
+
+    // 需要刷新：没有快照或已过期，且当前没有进行中的刷新
+    bool needsRefresh(const QString &cityName) const;
+
+    void setFreshTtl(int freshMs) { m_freshMs = freshMs; }
+    int freshTtl() const { return m_freshMs; }
+    void clear();
+    qsizetype count() const { return m_entries.count(); }
+
+    // 由数据包生成某个视图需要的数据
+    static QVariantMap project(const CityWeatherBundle &bundle, const QString &viewMode);
+
+private:
+    struct Entry {
+        CityWeatherBundlePtr bundle;
+        QDeadlineTimer staleAt;
+        qint64 fetchedAtMs = 0;
+        QHash<QString, QVariantMap> views;
+    };
+
+    QCache<QString, Entry> m_entries;
+    // 进行中的刷新（城市名），不随快照淘汰
+    QHash<QString, bool> m_refreshing;
+    int m_freshMs;
+};
+
+#endif // WEATHERSNAPSHOTSTORE_HPP
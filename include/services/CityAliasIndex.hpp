@@ -0,0 +1,30 @@
+#ifndef CITYALIASINDEX_HPP
+#define CITYALIASINDEX_HPP
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QStringView>
+
+// 城市别名索引：英文名、旧式拼写（Peking、Canton）和唯一的全拼，一次哈希查找得到城市
+// 别名表在构建期由citycodegen编译进程序，这里只建立指向只读文本的哈希表
+class CityAliasIndex
+{
+public:
+    CityAliasIndex();
+
+    // 别名对应的城市在CityDirectory中的下标，未找到返回-1
+    // 大小写、空格、撇号、连字符均忽略；逗号之后的部分（如"Beijing,CN"中的国家）也忽略
+    qsizetype indexOf(QStringView alias) const;
+
+    // 别名数量
+    qsizetype count() const { return m_aliases.size(); }
+
+    // 规范化别名：取第一个逗号之前的部分，只保留字母并转为小写；含非ASCII字符时返回空
+    static QByteArray normalize(QStringView alias);
+
+private:
+    QHash<QByteArrayView, quint32> m_aliases;
+};
+
+#endif // CITYALIASINDEX_HPP
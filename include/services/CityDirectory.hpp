@@ -0,0 +1,35 @@
+#ifndef CITYDIRECTORY_HPP
+#define CITYDIRECTORY_HPP
+
+#include <QString>
+#include <QStringView>
+
+// 城市目录：对构建期生成的只读城市表（CityDirectoryData）的轻量封装
+// 不复制任何数据，所有查询都直接在编译进程序的表上进行
+class CityDirectory
+{
+public:
+    CityDirectory() = default;
+
+    // 城市数量
+    qsizetype count() const;
+    // 第index条记录的名称和代码（按名称排序）
+    QStringView nameAt(qsizetype index) const;
+    quint32 numericCodeAt(qsizetype index) const;
+    QString codeAt(qsizetype index) const;
+
+    // 按名称查找城市下标（二分查找），未找到返回-1
+    qsizetype indexOf(QStringView cityName) const;
+    // 是否包含指定城市
+    bool contains(QStringView cityName) const { return indexOf(cityName) >= 0; }
+    // 按名称查找城市代码，未找到返回空字符串
+    QString codeForName(QStringView cityName) const;
+
+    // 编译进程序的只读表（城市表、名称、层级表、拼音键、别名）占用的字节数
+    static qsizetype tableFootprint();
+    // 同样内容放在QMap<QString, QString>（名称 -> 代码文本）中时的估算堆内存，用于对比
+    // 只是按64位平台分配器行为的估算，实测见tools/citybench
+    static qsizetype legacyMapFootprint();
+};
+
+#endif // CITYDIRECTORY_HPP
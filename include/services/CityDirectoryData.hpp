@@ -0,0 +1,78 @@
+#ifndef CITYDIRECTORYDATA_HPP
+#define CITYDIRECTORYDATA_HPP
+
+#include <QtGlobal>
+
+// 构建期由 tools/citycodegen 根据 citycode-2019-08-23.json、citypinyin-2019-08-23.json
+// 和 cityalias-2019-08-23.json 生成的只读城市表
+// 数据直接编译进可执行文件，运行时原地使用，无需解析
+namespace CityDirectoryData {
+
+// 表示“无”的下标（没有父节点、不在城市表中），对外接口使用
+constexpr quint32 kNoIndex = 0xFFFFFFFFu;
+// 表中16位下标列里的“无”（约2500个节点，citycodegen保证节点数小于它）
+constexpr quint16 kNoNode = 0xFFFFu;
+
+// 把表中的16位下标转换为对外的下标
+constexpr quint32 widenIndex(quint16 index)
+{
+    return index == kNoNode ? kNoIndex : quint32(index);
+}
+
+// 城市表，按名称（UTF-16码元序）排序，每列单独存放
+// 二分查找只读名称列，代码和节点列只在命中后读取
+extern const quint32 kEntryNameOffsets[];  // 名称在kNames中的起始位置
+extern const quint16 kEntryNameLengths[];  // 名称长度（UTF-16码元）
+extern const quint32 kEntryCodes[];        // 9位数字城市代码
+extern const quint16 kEntryNodes[];        // 在层级表中的下标
+extern const quint32 kEntryCount;
+// 所有城市名称首尾相连存放（先是城市表中的城市，再是没有代码的节点）
+extern const char16_t kNames[];
+extern const quint32 kNamesLength;
+
+// 层级表（省、市、区县），按JSON文件顺序存放，同名记录全部保留，每列单独存放
+extern const quint32 kNodeNameOffsets[];  // 名称在kNames中的起始位置
+extern const quint16 kNodeNameLengths[];  // 名称长度（UTF-16码元）
+extern const quint32 kNodeCodes[];        // 9位数字城市代码，省份等没有代码的节点为0
+extern const quint16 kNodeParents[];      // 父节点下标，顶层节点为kNoNode
+extern const quint16 kNodeEntries[];      // 在城市表中的下标，没有代码的节点为kNoNode
+extern const quint16 kNodeChildOffsets[]; // 子节点在kChildren中的起始位置
+extern const quint16 kNodeChildCounts[];  // 子节点数量
+extern const quint32 kNodeCount;
+// 各节点的子节点下标，按父节点分段连续存放
+extern const quint16 kChildren[];
+
+// 拼音键类型
+enum PinyinKeyKind : quint8 {
+    FullPinyin = 0,  // 全拼，如 beijing
+    Initials = 1     // 首字母，如 bj
+};
+
+// 一条拼音键，表按键文本（ASCII序）排序，相同前缀的键连续存放
+struct PinyinKey {
+    quint32 textOffset;  // 键文本在kPinyinText中的起始位置
+    quint32 entryIndex;  // 在城市表中的下标
+    quint8 textLength;   // 键文本长度
+    quint8 kind;         // PinyinKeyKind
+};
+
+extern const PinyinKey kPinyinKeys[];
+extern const quint32 kPinyinKeyCount;
+// 所有拼音键首尾相连存放（小写ASCII）
+extern const char kPinyinText[];
+
+// 一条别名（英文名、旧式拼写、唯一的全拼），按文本排序
+struct Alias {
+    quint32 textOffset;  // 别名文本在kAliasText中的起始位置
+    quint32 entryIndex;  // 在城市表中的下标
+    quint8 textLength;   // 别名文本长度
+};
+
+extern const Alias kAliases[];
+extern const quint32 kAliasCount;
+// 所有别名首尾相连存放（只含小写字母）
+extern const char kAliasText[];
+
+}
+
+#endif // CITYDIRECTORYDATA_HPP
@@ -0,0 +1,36 @@
+#ifndef CITYFUZZYMATCHER_HPP
+#define CITYFUZZYMATCHER_HPP
+
+#include <QList>
+#include <QStringView>
+#include "CityDirectory.hpp"
+
+// 城市名称近似匹配：Myers/Hyyrö位并行编辑距离，整表扫描
+// 查询的每个字对应一个位，一个名称只需按字做几次位运算，长度差超过阈值的名称直接跳过
+class CityFuzzyMatcher
+{
+public:
+    // 一条近似匹配结果
+    struct Match {
+        qsizetype index;  // 城市在目录中的下标
+        int distance;     // 与查询的编辑距离
+    };
+
+    // 位并行内核支持的最长查询
+    static constexpr qsizetype kMaxQueryLength = 64;
+
+    explicit CityFuzzyMatcher(const CityDirectory &directory = CityDirectory());
+
+    // 编辑距离不超过maxDistance的城市，按距离、名称长度排序，最多返回limit条
+    // maxDistance < 0 时按查询长度自动选择（每3个字允许1处错误，至少1处）；total非空时写入全部匹配数量
+    QList<Match> findApproximate(QStringView query, int maxDistance = -1, qsizetype limit = 20,
+                                 qsizetype *total = nullptr) const;
+
+    // 两个字符串之间的编辑距离，query超过kMaxQueryLength时返回-1
+    static int distance(QStringView query, QStringView text);
+
+private:
+    CityDirectory m_directory;
+};
+
+#endif // CITYFUZZYMATCHER_HPP
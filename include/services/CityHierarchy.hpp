@@ -0,0 +1,68 @@
+#ifndef CITYHIERARCHY_HPP
+#define CITYHIERARCHY_HPP
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+// 省/市/区县层级索引：构建于生成的层级表（CityDirectoryData::kNode*列）之上
+// 同名地点全部保留，可按代码、按名称（返回所有候选）、按父节点查询，均为O(1)
+// 支持"朝阳 (北京)"这样带上级地名的写法来区分同名地点
+class CityHierarchy
+{
+public:
+    CityHierarchy();
+
+    // 节点数量（包括没有城市代码的省份）
+    qsizetype nodeCount() const;
+    // 节点名称
+    QStringView nameAt(quint32 node) const;
+    // 节点的城市代码，没有代码时为0
+    quint32 codeAt(quint32 node) const;
+    // 父节点，顶层节点返回CityDirectoryData::kNoIndex
+    quint32 parentOf(quint32 node) const;
+    // 直接子节点
+    QList<quint32> childrenOf(quint32 node) const;
+    // 从父节点到顶层的祖先链
+    QList<quint32> ancestorsOf(quint32 node) const;
+    // 节点在CityDirectory中的下标，没有代码时返回-1
+    qsizetype directoryIndexOf(quint32 node) const;
+    // CityDirectory中第index条城市对应的节点
+    quint32 nodeOfDirectoryIndex(qsizetype index) const;
+
+    // 按城市代码查找节点，未找到返回kNoIndex
+    quint32 nodeForCode(quint32 cityCode) const;
+    // 按名称查找所有候选：优先完整名称，否则按去掉"市/区/县"后缀的名称匹配（朝阳 -> 朝阳市、朝阳区；北京市 -> 北京）
+    QList<quint32> nodesNamed(QStringView name) const;
+    // 名称是否对应多个地点
+    bool isAmbiguous(QStringView name) const { return nodesNamed(name).size() > 1; }
+
+    // 解析用户输入的地名（可带"(上级地名)"），只返回有城市代码的节点，未找到返回kNoIndex
+    // 多个候选时优先层级较高的，其次是文件中靠前的
+    quint32 resolve(QStringView query) const;
+    // 带上级地名的显示名称，如"朝阳区 (北京)"，顶层节点只返回名称
+    QString qualifiedName(quint32 node) const;
+
+    // 去掉行政区划后缀后的名称
+    static QStringView baseName(QStringView name);
+
+    // 索引占用的堆内存（字节，哈希表按容量估算）
+    qsizetype memoryFootprint() const;
+
+private:
+    // 节点或其任一祖先的名称与qualifier匹配
+    bool hasAncestorNamed(quint32 node, QStringView qualifier) const;
+    int depthOf(quint32 node) const;
+
+    // 同名候选用链表串起来：哈希表只存第一个节点，m_nextSameName[node]指向下一个同名节点
+    QList<quint32> collectChain(quint32 head, const QList<quint32> &next) const;
+
+    QHash<quint32, quint32> m_byCode;
+    QHash<QStringView, quint32> m_byName;
+    QHash<QStringView, quint32> m_byBaseName;
+    QList<quint32> m_nextSameName;
+    QList<quint32> m_nextSameBase;
+};
+
+#endif // CITYHIERARCHY_HPP
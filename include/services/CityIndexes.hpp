@@ -0,0 +1,23 @@
+#ifndef CITYINDEXES_HPP
+#define CITYINDEXES_HPP
+
+#include "CityDirectory.hpp"
+#include "CityHierarchy.hpp"
+#include "CitySearchIndex.hpp"
+#include "CityPinyinIndex.hpp"
+#include "CityFuzzyMatcher.hpp"
+#include "CityAliasIndex.hpp"
+
+// 城市目录之上的全部运行时索引，一次性在工作线程上构建，构建完成后只读
+// 只读对象可以在线程间共享，GUI线程通过shared_ptr持有
+struct CityIndexes
+{
+    CityDirectory directory;
+    CityHierarchy hierarchy;
+    CitySearchIndex searchIndex{directory};
+    CityPinyinIndex pinyinIndex;
+    CityFuzzyMatcher fuzzyMatcher{directory};
+    CityAliasIndex aliasIndex;
+};
+
+#endif // CITYINDEXES_HPP
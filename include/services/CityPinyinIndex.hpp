@@ -0,0 +1,30 @@
+#ifndef CITYPINYININDEX_HPP
+#define CITYPINYININDEX_HPP
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+// 城市拼音前缀索引：构建期生成的全拼/首字母键表（按键排序，即展平的前缀树）
+// 查询只做两次二分查找定位前缀区间，再对区间内的少量候选排序，适合逐键实时联想
+class CityPinyinIndex
+{
+public:
+    CityPinyinIndex() = default;
+
+    // 查询是否可以按拼音处理（只含ASCII字母，允许空格、连字符和隔音符'）
+    static bool isPinyinQuery(QStringView query);
+
+    // 全拼或首字母以query开头的城市下标，按匹配程度排序，最多返回limit条
+    // total非空时写入全部匹配的城市数量
+    QList<qsizetype> findPrefix(QStringView query, qsizetype limit = 20, qsizetype *total = nullptr) const;
+
+    // 键表中的键数量
+    qsizetype keyCount() const;
+
+private:
+    // 规范化查询：转小写并去掉空格、连字符和隔音符，非法字符返回空
+    static QByteArray normalize(QStringView query);
+};
+
+#endif // CITYPINYININDEX_HPP
@@ -0,0 +1,48 @@
+#ifndef CITYSEARCHINDEX_HPP
+#define CITYSEARCHINDEX_HPP
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include "CityDirectory.hpp"
+
+// 城市名称子串搜索索引：单字 + 双字（bigram）倒排表
+// 查询时取各bigram的倒排表求交集，再对少量候选做一次子串校验
+// 存储为压缩行格式：有序键数组 + 偏移数组 + 一整块倒排数组，不为每个键单独分配内存
+class CitySearchIndex
+{
+public:
+    explicit CitySearchIndex(const CityDirectory &directory = CityDirectory());
+
+    // 名称中包含query（不区分大小写）的城市下标，按名称排序
+    QList<qsizetype> findSubstring(QStringView query) const;
+
+    // 索引中的倒排项总数
+    qsizetype postingCount() const { return m_postings.size(); }
+    // 索引键数量（单字 + 双字）
+    qsizetype keyCount() const { return m_keys.size(); }
+    // 索引占用的堆内存（字节）
+    qsizetype memoryFootprint() const;
+
+private:
+    // 一个键对应的倒排区间
+    struct PostingRange {
+        const quint32 *begin = nullptr;
+        const quint32 *end = nullptr;
+        qsizetype size() const { return end - begin; }
+    };
+
+    PostingRange postingsFor(quint32 key) const;
+
+    // 单字键就是UTF-16码元本身（< 0x10000），双字键为两个码元拼接（>= 0x10000），共用一张表
+    static quint32 unigramKey(QChar ch);
+    static quint32 bigramKey(QChar first, QChar second);
+    static QString foldCase(QStringView text);
+
+    CityDirectory m_directory;
+    QList<quint32> m_keys;     // 有序键
+    QList<quint32> m_offsets;  // 第i个键的倒排为m_postings[m_offsets[i], m_offsets[i + 1])
+    QList<quint32> m_postings; // 所有倒排表首尾相连
+};
+
+#endif // CITYSEARCHINDEX_HPP
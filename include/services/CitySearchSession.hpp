@@ -0,0 +1,66 @@
+#ifndef CITYSEARCHSESSION_HPP
+#define CITYSEARCHSESSION_HPP
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include "CityDirectory.hpp"
+#include "CitySearchIndex.hpp"
+#include "CityPinyinIndex.hpp"
+#include "CityFuzzyMatcher.hpp"
+#include "CityAliasIndex.hpp"
+
+// 边输入边搜索的会话：记住之前查询的候选集合
+// 新查询是上一次查询的延长（石 -> 石家 -> 石家庄）时只在旧候选里过滤；退格时回退到仍然适用的那一步
+// 结果按页返回，只对请求页范围内的候选做排序；没有精确匹配时退回到编辑距离近似匹配
+class CitySearchSession
+{
+public:
+    // 一页搜索结果
+    struct Page {
+        QList<qsizetype> indices;  // 本页城市在目录中的下标
+        qsizetype offset = 0;      // 本页起始位置
+        qsizetype total = 0;       // 全部匹配数量
+        bool approximate = false;  // 结果来自近似匹配（查询可能有错别字）
+        QList<int> distances;      // 近似匹配时每条结果的编辑距离
+    };
+
+    CitySearchSession(const CityDirectory &directory, const CitySearchIndex &searchIndex,
+                      const CityPinyinIndex &pinyinIndex, const CityFuzzyMatcher &fuzzyMatcher,
+                      const CityAliasIndex &aliasIndex);
+
+    // 搜索并返回[offset, offset + limit)范围内的结果
+    Page search(QStringView query, qsizetype offset, qsizetype limit);
+    // 丢弃记住的候选集合
+    void reset();
+
+    // 统计：在旧候选上过滤的次数、完整查询索引的次数
+    qint64 narrowedCount() const { return m_narrowedCount; }
+    qint64 fullSearchCount() const { return m_fullSearchCount; }
+
+private:
+    // 查询链中的一步：该查询及其全部候选（按目录顺序）
+    struct Step {
+        QString query;
+        QList<qsizetype> candidates;
+    };
+
+    const QList<qsizetype> &candidatesFor(const QString &query);
+    Page rankPage(const QString &query, const QList<qsizetype> &candidates, qsizetype offset, qsizetype limit) const;
+    Page approximatePage(const QString &query, qsizetype offset, qsizetype limit) const;
+    // 别名命中的城市排在最前，其后是去掉它的完整排名
+    static Page aliasFirstPage(qsizetype aliasHit, QList<qsizetype> ranked, qsizetype offset, qsizetype limit);
+
+    const CityDirectory &m_directory;
+    const CitySearchIndex &m_searchIndex;
+    const CityPinyinIndex &m_pinyinIndex;
+    const CityFuzzyMatcher &m_fuzzyMatcher;
+    const CityAliasIndex &m_aliasIndex;
+
+    // 逐步变长的查询链，末尾为最近一次查询
+    QList<Step> m_steps;
+    qint64 m_narrowedCount = 0;
+    qint64 m_fullSearchCount = 0;
+};
+
+#endif // CITYSEARCHSESSION_HPP
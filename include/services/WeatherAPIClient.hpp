@@ -11,7 +11,16 @@
 #include <QVariantList>
 #include <QTimer>
 #include <QMap>
+#include <QHash>
+#include <QThreadPool>
 #include <functional>
+#include <memory>
+#include "WeatherResponseCache.hpp"
+#include "WeatherRequest.hpp"
+#include "CityDirectory.hpp"
+#include "CityIndexes.hpp"
+#include "CitySearchSession.hpp"
+#include "../commonDataType/CityWeatherBundle.hpp"
 
 class WeatherAPIClient : public QObject
 {
@@ -21,6 +30,20 @@ public:
     explicit WeatherAPIClient(QObject *parent = nullptr);
     ~WeatherAPIClient();
 
+    // 进程内共享的客户端实例（仅在GUI线程使用），随QCoreApplication销毁
+    static WeatherAPIClient *shared();
+
+    // 数据包回调：成功时bundle非空，失败时error为错误信息
+    using BundleCallback = std::function<void(const CityWeatherBundlePtr &bundle, const QString &error)>;
+
+    // 获取城市天气数据包：类型化的当前天气和预报，不经过QVariantMap
+    // 返回可传给cancel的请求标识；在本次调用内已完成（命中缓存、城市不存在）时返回0
+    WeatherRequestId getWeatherBundle(const QString &cityName, BundleCallback callback);
+    // 取消getWeatherBundle发起的请求：回调不再执行
+    // 相同URL合并的请求中最后一个等待者取消时中止网络回复；解析中的结果直接丢弃
+    void cancel(WeatherRequestId requestId);
+
+    // 以下接口返回QVariantMap投影，供QML回调使用
     // 获取城市当前天气
     void getCurrentWeather(const QString &cityName, std::function<void(const QVariantMap&)> callback);
     
@@ -36,8 +59,13 @@ public:
     // 获取日出日落信息
     void getSunriseInfo(const QString &cityName, std::function<void(const QVariantMap&)> callback);
     
-    // 搜索城市
+    // 搜索结果默认每页条数
+    static constexpr int kSearchPageSize = 20;
+
+    // 搜索城市（返回排名最前的一页结果）
     void searchCities(const QString &query, std::function<void(const QVariantList&)> callback);
+    // 分页搜索城市：page包含query、offset、total、hasMore、approximate和results列表
+    void searchCitiesPage(const QString &query, int offset, int limit, std::function<void(const QVariantMap&)> callback);
     
     // 设置API密钥
     void setApiKey(const QString &apiKey);
@@ -45,21 +73,53 @@ public:
     // 设置API基础URL
     void setBaseUrl(const QString &baseUrl);
 
-private slots:
-    void onNetworkReplyFinished();
+    // 设置响应缓存的默认存活时间（毫秒）
+    void setCacheTtl(int ttlMs);
+    // 设置响应缓存的内存预算（字节）
+    void setCacheMemoryBudget(qint64 maxBytes);
+    // 清空响应缓存
+    void clearCache();
+    // 获取缓存命中/未命中等统计信息
+    QVariantMap cacheStats() const;
+    // 获取请求数量、合并次数及平均耗时统计
+    QVariantMap requestStats() const;
+    // 获取城市目录及各索引的内存占用统计
+    QVariantMap directoryStats() const;
+
+    // 城市索引是否已在后台构建完成
+    bool isDirectoryReady() const { return m_indexes != nullptr; }
+    // 索引就绪后在GUI线程执行task；已就绪时立即执行
+    void whenDirectoryReady(std::function<void()> task);
+
+signals:
+    // 城市索引构建完成
+    void directoryReady();
 
 private:
-    // 发送HTTP GET请求
-    void sendRequest(const QString &url, std::function<void(const QVariantMap&)> callback);
+    // 发送HTTP GET请求：相同URL合并，完成时由请求描述对象自行解析和分发
+    // 返回实际承载该请求的描述对象（合并时为已有的请求）
+    template <typename Result>
+    std::shared_ptr<WeatherRequest<Result>> sendRequest(WeatherRequest<Result> request,
+                     QHash<QString, std::shared_ptr<WeatherRequest<Result>>> &inFlight);
     void sendRequestForList(const QString &url, std::function<void(const QVariantList&)> callback);
-    
-    // 解析天气数据
-    QVariantMap parseCurrentWeatherData(const QJsonObject &json);
-    QVariantMap parseWeeklyForecastData(const QJsonObject &json);
-    QVariantMap parseDailyForecastData(const QJsonObject &json);
-    QVariantMap parseDetailedWeatherData(const QJsonObject &json);
-    QVariantMap parseSunriseData(const QJsonObject &json);
-    QVariantList parseCitySearchData(const QJsonArray &json);
+    // 在工作线程上构建城市索引，完成后回到GUI线程安装并执行排队的查询
+    void loadDirectoryAsync();
+    // 索引未就绪时把task排队并返回true，调用方应直接返回
+    bool deferUntilDirectoryReady(std::function<void()> task);
+    // 把城市名称（可带上级地名）解析为城市代码，未找到返回空字符串
+    QString codeForCity(const QString &cityName) const;
+    // 按请求标识执行getWeatherBundle（城市目录就绪后可能延迟执行）
+    void startWeatherBundle(WeatherRequestId requestId, const QString &cityName, BundleCallback callback);
+    // 获取城市天气，优先使用未过期的缓存
+    void fetchCityWeather(const QString &cityCode, WeatherRequestId requestId, BundleCallback callback);
+    
+    // 响应解析器
+    static CityWeatherBundlePtr parseWeatherResponse(const QByteArray &data, QString *error);
+    static QVariantList parseSearchResponse(const QByteArray &data, QString *error);
+    static QVariantList parseCitySearchData(const QJsonArray &json);
+
+    // 记录一次请求完成的耗时统计
+    void recordRequestFinished(const QString &requestKey, qint64 networkNs, qint64 dispatchNs);
     
     // 构建API URL
     QString buildCurrentWeatherUrl(const QString &cityName);
@@ -72,12 +132,6 @@ private:
     QVariantMap createErrorResponse(const QString &error, const QString &cityName = "");
     QVariantList createErrorListResponse(const QString &error);
     
-    // 城市名称翻译
-    QString translateCityName(const QString &englishName);
-    
-    // 城市代码加载
-    void loadCityCodes();
-    
     // 网络管理
     QNetworkAccessManager *m_networkManager;
     
@@ -85,12 +139,38 @@ private:
     QString m_apiKey;
     QString m_baseUrl;
     
-    // 城市代码映射
-    QMap<QString, QString> m_cityCodeMap;
-    
-    // 请求回调映射
-    QHash<QNetworkReply*, std::function<void(const QVariantMap&)>> m_callbacks;
-    QHash<QNetworkReply*, std::function<void(const QVariantList&)>> m_listCallbacks;
+    // 城市目录（名称 -> 城市代码），编译进程序，随时可用
+    CityDirectory m_cityDirectory;
+    // 层级、子串、拼音、近似匹配索引，后台构建完成前为空
+    std::shared_ptr<const CityIndexes> m_indexes;
+    // 边输入边搜索的会话（复用上一次查询的候选集合），随索引一起创建
+    std::unique_ptr<CitySearchSession> m_searchSession;
+    // 索引就绪前到达的查询
+    QList<std::function<void()>> m_pendingLookups;
+
+    // 已解析响应缓存（按城市代码）
+    WeatherResponseCache m_cache;
+    
+    // 进行中的请求（URL -> 请求描述），用于合并相同请求
+    QHash<QString, std::shared_ptr<WeatherRequest<CityWeatherBundlePtr>>> m_inFlightWeather;
+    QHash<QString, std::shared_ptr<WeatherRequest<QVariantList>>> m_inFlightSearch;
+    // 尚未完成、可取消的数据包请求（标识 -> 承载的请求，等待城市目录时为空）
+    QHash<WeatherRequestId, std::weak_ptr<WeatherRequest<CityWeatherBundlePtr>>> m_liveRequests;
+    WeatherRequestId m_nextRequestId = 0;
+
+    // 响应解析线程池
+    QThreadPool m_parsePool;
+
+    // 请求统计
+    struct RequestStats {
+        qint64 issued = 0;
+        qint64 coalesced = 0;
+        qint64 completed = 0;
+        qint64 cancelled = 0;
+        qint64 totalNetworkNs = 0;
+        qint64 totalDispatchNs = 0; // 解析 + 回线程 + 回调
+    };
+    RequestStats m_requestStats;
 };
 
 #endif // WEATHERAPICLIENT_HPP
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef WEATHERDATABUS_HPP
+#define WEATHERDATABUS_HPP
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <functional>
+#include <memory>
+#include "../commonDataType/CityWeatherBundle.hpp"
+
+// 天气数据总线：按城市和数据种类订阅，只投递给关心该城市的接收者
+// 投递在发布线程（GUI线程）上同步进行，传递的是不可变数据包的引用，不做复制或转换
+// 接收者销毁时自动退订
+class WeatherDataBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 数据种类
+    enum Kind {
+        BundleKind = 0,   // 完整数据包（共享指针，可保留）
+        CurrentKind,      // 当前天气
+        ForecastKind,     // 预报列表
+        ErrorKind,        // 加载失败
+        KindCount
+    };
+
+    using SubscriptionId = quint64;
+
+    // 进程内共享的总线（仅在GUI线程使用），随QCoreApplication销毁
+    static WeatherDataBus *shared();
+
+    explicit WeatherDataBus(QObject *parent = nullptr);
+
+    // 订阅某个城市的数据；receiver销毁后自动退订，回调不再执行
+    // replayLatest为true且该城市已有发布过的数据包时，订阅后立即投递一次
+    SubscriptionId subscribeBundle(const QString &cityName, QObject *receiver,
+                                   std::function<void(const CityWeatherBundlePtr &bundle)> handler,
+                                   bool replayLatest = false);
+    SubscriptionId subscribeCurrent(const QString &cityName, QObject *receiver,
+                                    std::function<void(const CurrentConditions &conditions)> handler,
+                                    bool replayLatest = false);
+    SubscriptionId subscribeForecast(const QString &cityName, QObject *receiver,
+                                     std::function<void(const QList<DailyForecast> &days)> handler,
+                                     bool replayLatest = false);
+    SubscriptionId subscribeErrors(const QString &cityName, QObject *receiver,
+                                   std::function<void(const QString &error)> handler);
+
+    // 退订单个订阅；id为0时什么也不做
+    void unsubscribe(SubscriptionId id);
+    // 退订receiver的全部订阅
+    void unsubscribeAll(QObject *receiver);
+
+    // 发布城市的新数据包：同一个数据包（例如命中缓存的重复结果）对每个订阅只投递一次
+    void publish(const QString &cityName, const CityWeatherBundlePtr &bundle);
+    // 发布城市的加载错误
+    void publishError(const QString &cityName, const QString &error);
+    // 城市最后发布的数据包（仍有持有者时），没有时返回空指针（并移除失效的记录）
+    CityWeatherBundlePtr latest(const QString &cityName);
+
+    // 当前订阅数（调试用）
+    qsizetype subscriptionCount() const { return m_keys.size(); }
+
+private:
+    // 内部统一的回调形式，bundle为空时表示错误
+    using Handler = std::function<void(const CityWeatherBundlePtr &bundle, const QString &error)>;
+
+    struct Subscription {
+        SubscriptionId id;
+        QPointer<QObject> receiver;
+        Handler handler;
+        // 最后投递给该订阅的数据包
+        std::weak_ptr<const CityWeatherBundle> lastDelivered;
+    };
+    struct Key {
+        Kind kind = BundleKind;
+        QString cityName;
+    };
+
+    SubscriptionId addSubscription(Kind kind, const QString &cityName, QObject *receiver, Handler handler,
+                                   bool replayLatest);
+    void deliver(Kind kind, const QString &cityName, const CityWeatherBundlePtr &bundle, const QString &error);
+    void onReceiverDestroyed(QObject *receiver);
+    // 城市已没有任何订阅时移除它的最后数据包记录
+    void releaseCity(const QString &cityName);
+
+    // 每种数据：城市名 -> 订阅列表
+    QHash<QString, QList<Subscription>> m_subscriptions[KindCount];
+    // 订阅id -> 所在位置，用于退订
+    QHash<SubscriptionId, Key> m_keys;
+    // 接收者 -> 它的订阅id，接收者销毁时整体移除
+    QHash<QObject *, QList<SubscriptionId>> m_byReceiver;
+    // 每个城市最后发布的数据包（不延长其生命周期）；失效的记录在查询或城市的最后一个订阅退订时移除
+    QHash<QString, std::weak_ptr<const CityWeatherBundle>> m_latest;
+    SubscriptionId m_nextId = 0;
+};
+
+#endif // WEATHERDATABUS_HPP
@@ -8,7 +8,11 @@
 #include <QTimer>
 #include <QRandomGenerator>
 #include <QJSValue>
+#include <QPointer>
 #include <functional>
+#include "../commonDataType/WeatherTypes.hpp"
+#include "../commonDataType/CityWeatherBundle.hpp"
+#include "WeatherRequest.hpp"
 
 class WeatherAPIClient;
 
@@ -33,24 +37,50 @@ public:
     Q_INVOKABLE void getSunriseInfo(const QString &cityName,  const QJSValue &callback = QJSValue());
     // 根据查询字符串搜索城市
     Q_INVOKABLE void searchCities(const QString &query, const QJSValue &callback = QJSValue());
+    // 分页搜索城市，回调参数为 {query, offset, total, hasMore, results}
+    Q_INVOKABLE void searchCitiesPage(const QString &query, int offset, int limit, const QJSValue &callback = QJSValue());
 
 
 
     Q_INVOKABLE bool validateCityName(const QString &cityName);
 
+    // 城市目录索引是否已加载完成（未完成时的查询会排队，完成后自动执行）
+    Q_INVOKABLE bool isDirectoryReady() const;
+
+    // 获取城市的类型化数据包（结果同时发布到WeatherDataBus）
+    // 回调参数为(bundle, error)，bundle为空表示失败；服务销毁后不再回调
+    // 返回可传给cancelRequest的标识，已同步完成时返回0
+    using BundleCallback = std::function<void(const CityWeatherBundlePtr &, const QString &)>;
+    WeatherRequestId fetchBundle(const QString &cityName, BundleCallback callback);
+    // 取消fetchBundle发起的请求，回调不再执行
+    void cancelRequest(WeatherRequestId requestId);
+
 signals:
-    // 当天气数据加载完成时调用此方法，传入天气数据的 QVariantMap 对象
-    void dataLoaded(const QVariantMap &weatherData);
-    // 当天气数据加载出错时调用此方法，传入错误信息的 QString 对象
-    void dataLoadError(const QString &error);
     // 当搜索结果准备好时发出此信号
     void searchResultsReady(const QVariantList &results);
+    // 城市目录索引加载完成
+    void directoryReady();
 
 private:
     // 延迟调用指定函数的方法，传入函数对象和延迟时间（默认为100毫秒）
     void callLater(std::function<void()> func , int delayMs = 100);
+    // 所有数据包请求的入口：把结果发布到数据总线后再交给callback
+    WeatherRequestId requestBundle(const QString &cityName, BundleCallback callback);
+    // 调用QML回调，value在这里才转换为脚本值
+    void invokeCallback(const QJSValue &callback, const QVariant &value);
+
+    // 包装API回调：共享客户端比服务活得久，服务销毁后不再执行回调
+    template <typename Func>
+    auto guarded(Func func)
+    {
+        return [self = QPointer<WeatherDataService>(this), func](const auto &...results) {
+            if (self) {
+                func(results...);
+            }
+        };
+    }
     
-    // API客户端
+    // API客户端（进程内共享，不归本对象所有）
     WeatherAPIClient *m_apiClient;
 };
 
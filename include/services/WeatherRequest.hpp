@@ -0,0 +1,120 @@
+#ifndef WEATHERREQUEST_HPP
+#define WEATHERREQUEST_HPP
+
+#include <QUrl>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <functional>
+#include <utility>
+
+// 调用方持有的请求标识，可用于取消；0表示没有可取消的请求
+using WeatherRequestId = quint64;
+
+// 一次HTTP请求的描述对象：自带解析器和完成回调（可合并多个等待者）
+// 只能移动不能复制，finish保证回调只执行一次
+// 解析器必须是无状态的，会在工作线程上调用；回调始终在发起请求的线程执行
+// 等待者可以单独取消；最后一个等待者取消时整个请求中止
+template <typename Result>
+class WeatherRequest
+{
+public:
+    // 解析器：把响应体转换为结果，失败时写入error
+    using Parser = std::function<Result(const QByteArray &data, QString *error)>;
+    // 完成回调：成功时error为空
+    using Handler = std::function<void(const Result &result, const QString &error)>;
+    // 解析结果（在线程间传递）
+    struct Outcome {
+        Result result{};
+        QString error;
+    };
+
+    WeatherRequest(const QUrl &url, Parser parser, Handler handler, WeatherRequestId waiterId = 0)
+        : m_url(url)
+        , m_parser(std::move(parser))
+        , m_completed(false)
+    {
+        m_waiters.append({waiterId, std::move(handler)});
+        m_timer.start();
+    }
+
+    WeatherRequest(WeatherRequest &&other) = default;
+    WeatherRequest &operator=(WeatherRequest &&other) = default;
+    WeatherRequest(const WeatherRequest &) = delete;
+    WeatherRequest &operator=(const WeatherRequest &) = delete;
+
+    const QUrl &url() const { return m_url; }
+    bool isCompleted() const { return m_completed; }
+    qsizetype waiterCount() const { return m_waiters.size(); }
+    // 从创建到现在经过的时间（纳秒）
+    qint64 elapsedNs() const { return m_timer.nsecsElapsed(); }
+
+    // 合并相同URL的另一个请求：只接管它的等待者
+    void mergeWaiters(WeatherRequest &&other)
+    {
+        m_waiters.append(std::exchange(other.m_waiters, {}));
+        other.m_completed = true;
+    }
+
+    // 设置中止操作（例如中止网络回复），最后一个等待者取消时调用
+    void setAbort(std::function<void()> abort) { m_abort = std::move(abort); }
+
+    // 取消一个等待者，它的回调不会再执行；没有等待者时请求标记为完成并中止
+    // 返回是否找到该等待者
+    bool cancelWaiter(WeatherRequestId waiterId)
+    {
+        if (m_completed || waiterId == 0) return false;
+
+        const qsizetype before = m_waiters.size();
+        m_waiters.removeIf([waiterId](const Waiter &waiter) { return waiter.id == waiterId; });
+        if (m_waiters.size() == before) return false;
+
+        if (m_waiters.isEmpty()) {
+            m_completed = true;
+            if (m_abort) {
+                std::exchange(m_abort, {})();
+            }
+        }
+        return true;
+    }
+
+    const Parser &parser() const { return m_parser; }
+
+    // 解析响应体，可在任意线程调用
+    static Outcome parse(const Parser &parser, const QByteArray &data)
+    {
+        Outcome outcome;
+        outcome.result = parser(data, &outcome.error);
+        return outcome;
+    }
+
+    // 直接以给定结果完成请求
+    void finish(const Result &result, const QString &error)
+    {
+        if (m_completed) return;
+        m_completed = true;
+
+        // 先取出回调，避免回调中重入修改列表
+        const QList<Waiter> waiters = std::exchange(m_waiters, {});
+        m_abort = {};
+        for (const Waiter &waiter : waiters) {
+            waiter.handler(result, error);
+        }
+    }
+
+private:
+    struct Waiter {
+        WeatherRequestId id;
+        Handler handler;
+    };
+
+    QUrl m_url;
+    Parser m_parser;
+    QList<Waiter> m_waiters;
+    std::function<void()> m_abort;
+    bool m_completed;
+    QElapsedTimer m_timer;
+};
+
+#endif // WEATHERREQUEST_HPP
@@ -0,0 +1,54 @@
+#ifndef WEATHERRESPONSECACHE_HPP
+#define WEATHERRESPONSECACHE_HPP
+
+#include <QCache>
+#include <QString>
+#include <QVariantMap>
+#include <QDeadlineTimer>
+#include "../commonDataType/CityWeatherBundle.hpp"
+
+// 已解析天气数据包的内存缓存：按城市代码索引，LRU淘汰 + 每条记录独立TTL
+class WeatherResponseCache
+{
+public:
+    // maxBytes: 内存预算（估算字节数），ttlMs: 默认存活时间
+    explicit WeatherResponseCache(qint64 maxBytes = 2 * 1024 * 1024, int ttlMs = 10 * 60 * 1000);
+
+    // 查找未过期的缓存数据，未命中时返回空指针
+    CityWeatherBundlePtr lookup(const QString &cityCode);
+    // 插入缓存，ttlMs < 0 时使用默认TTL
+    void insert(const QString &cityCode, const CityWeatherBundlePtr &bundle, int ttlMs = -1);
+    // 移除指定城市的缓存
+    void remove(const QString &cityCode);
+    // 清空缓存
+    void clear();
+
+    // 配置
+    void setMaxBytes(qint64 maxBytes);
+    void setDefaultTtl(int ttlMs);
+    qint64 maxBytes() const { return m_entries.maxCost(); }
+    int defaultTtl() const { return m_defaultTtlMs; }
+
+    // 统计信息
+    qint64 hits() const { return m_hits; }
+    qint64 misses() const { return m_misses; }
+    qint64 totalBytes() const { return m_entries.totalCost(); }
+    qsizetype count() const { return m_entries.count(); }
+    QVariantMap stats() const;
+
+    // 估算数据包占用的内存字节数
+    static qint64 estimateCost(const CityWeatherBundle &bundle);
+
+private:
+    struct Entry {
+        CityWeatherBundlePtr bundle;
+        QDeadlineTimer expiry;
+    };
+
+    QCache<QString, Entry> m_entries;
+    int m_defaultTtlMs;
+    qint64 m_hits;
+    qint64 m_misses;
+};
+
+#endif // WEATHERRESPONSECACHE_HPP
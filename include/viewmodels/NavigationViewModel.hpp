@@ -62,6 +62,8 @@ private:
     
     void initializeAvailableViews();
     int findViewIndex(const QString &viewId) const;
+    // 预取下一个视图的数据
+    void prefetchNextView();
 };
 
 #endif // NAVIGATIONVIEWMODEL_HPP
\ No newline at end of file
@@ -8,6 +8,12 @@
 #include <QJSValue>
 #include <QQmlEngine>
 #include <memory>
+#include "../commonDataType/WeatherTypes.hpp"
+#include "../commonDataType/WeatherDataModel.hpp"
+#include "../models/ForecastListModel.hpp"
+#include "../models/RecentCitiesModel.hpp"
+#include "../services/WeatherRequest.hpp"
+#include "../services/WeatherDataBus.hpp"
 
 // 前向声明
 class WeatherDataService;
@@ -22,6 +28,12 @@ class WeatherViewModel : public QObject{
     Q_PROPERTY(QString errorMessage READ errorMessage NOTIFY errorMessageChanged)
     // 定义当前天气数据的属性，只读，通过currentWeatherData方法访问，当天气数据改变时触发currentWeatherDataChanged信号
     Q_PROPERTY(QVariantMap currentWeatherData READ currentWeatherData NOTIFY currentWeatherDataChanged)
+    // 当前天气的数据模型，整个生命周期内是同一个对象，各属性单独通知变化
+    Q_PROPERTY(WeatherDataModel* weatherModel READ weatherModel CONSTANT)
+    // 多日预报列表模型，按行、按角色通知变化
+    Q_PROPERTY(ForecastListModel* forecastModel READ forecastModel CONSTANT)
+    // 最近城市列表模型（来自AppStateManager，initialize之前为空）
+    Q_PROPERTY(RecentCitiesModel* recentCitiesModel READ recentCitiesModel NOTIFY recentCitiesModelChanged)
 
 public:
     explicit WeatherViewModel(QObject *parent = nullptr);
@@ -33,6 +45,12 @@ public:
     QString errorMessage() const { return m_errorMessage; }
     // 返回当前的天气数据，以 QVariantMap 格式
     QVariantMap currentWeatherData() const { return m_currentWeatherData; }
+    // 返回当前天气的数据模型（归本对象所有）
+    WeatherDataModel *weatherModel() const { return m_weatherModel; }
+    // 返回多日预报列表模型（归本对象所有）
+    ForecastListModel *forecastModel() const { return m_forecastModel; }
+    // 返回最近城市列表模型
+    RecentCitiesModel *recentCitiesModel() const;
 
      // Public methods
         // 初始化函数，用于设置状态管理器
@@ -43,6 +61,8 @@ public:
         Q_INVOKABLE void loadWeatherData();
         // 根据查询字符串搜索城市，并在找到结果时调用回调函数
         Q_INVOKABLE void searchCities(const QString &query, const QJSValue &callback = QJSValue());
+        // 分页搜索城市，回调参数为 {query, offset, total, hasMore, results}
+        Q_INVOKABLE void searchCitiesPage(const QString &query, int offset, int limit, const QJSValue &callback = QJSValue());
         // 将城市数据添加到最近访问的城市列表中
         Q_INVOKABLE void addCityToRecent(const QVariantMap &cityData);
         // 切换视图模式
@@ -74,6 +94,7 @@ signals:
     void isLoadingChanged();
     void errorMessageChanged();
     void currentWeatherDataChanged();
+    void recentCitiesModelChanged();
     
     void weatherDataChanged(const QVariantMap &data);
     void loadingStateChanged(bool loading);
@@ -83,7 +104,7 @@ signals:
 private slots:
     void onCityChanged(const QVariantMap &cityData);
     void onViewModeChanged(const QString &viewMode);
-    void onDataLoaded(const QVariantMap &data);
+    void onCurrentConditionsLoaded(const CurrentConditions &conditions);
     void onDataLoadError(const QString &error);
     void onSearchResultsReady(const QVariantList &results);
 
@@ -91,6 +112,18 @@ private:
     bool m_isLoading;
     QString m_errorMessage;
     QVariantMap m_currentWeatherData;
+    // 长期持有的数据模型，每次响应就地更新，不再为每个响应新建对象
+    WeatherDataModel *m_weatherModel;
+    ForecastListModel *m_forecastModel;
+    // 当前加载请求：每次新加载递增代号，回调中代号不符的响应直接丢弃
+    quint64 m_loadGeneration;
+    WeatherRequestId m_loadRequest;
+    QString m_loadingCity;
+    // 正在显示的城市在数据总线上的订阅
+    QString m_subscribedCity;
+    // m_weatherModel中的天气属于哪个城市
+    QString m_weatherCity;
+    WeatherDataBus::SubscriptionId m_citySubscription;
     
     AppStateManager* m_appStateManager;
     std::unique_ptr<WeatherDataService> m_weatherDataService;
@@ -98,6 +131,14 @@ private:
     void setLoading(bool loading);
     void setError(const QString &error);
     void clearError();
+    // 加载城市天气，取代之前未完成的加载
+    void startLoad(const QString &cityName);
+    // 取消未完成的加载，之后到达的响应不再更新界面
+    void cancelLoad();
+    // 改为订阅cityName的当前天气（退订之前的城市）
+    void followCity(const QString &cityName);
+    // 给状态管理器的城市数据补上模型中该城市的天气字段（已有的字段不覆盖）
+    QVariantMap withWeather(const QVariantMap &cityData) const;
 
 };
 
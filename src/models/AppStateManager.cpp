@@ -1,24 +1,46 @@
 #include "../../include/models/AppStateManager.hpp"
 #include "../../include/services/WeatherDataService.hpp"
+#include "../../include/models/WeatherPrefetcher.hpp"
+#include "../../include/models/WarmStartFile.hpp"
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMetaMethod>
 
 AppStateManager::AppStateManager(QObject *parent) : QObject(parent)
     ,m_initialized(false)
     ,m_currentViewMode("today_weather")
+    ,m_recentCities(new RecentCitiesModel(this))
     ,m_currentCityIndex(0)
     ,m_maxCities(3)
+    ,m_hasWeatherData(false)
+    ,m_weatherDataCacheValid(false)
+    ,m_cityBundleSubscription(0)
+    ,m_cityErrorSubscription(0)
     ,m_weatherService(std::make_unique<WeatherDataService>(this))
+    ,m_prefetcher(new WeatherPrefetcher(&m_snapshots, m_weatherService.get(), this))
 {
-    // 连接WeatherDataService的信号
-    connect(m_weatherService.get(), &WeatherDataService::dataLoaded,
-            this, &AppStateManager::onWeatherDataLoaded);
-    connect(m_weatherService.get(), &WeatherDataService::dataLoadError,
-            this, &AppStateManager::onWeatherDataError);
+    // 预取的数据经数据总线到达当前城市的订阅，这里只需要记得写入启动快照
+    connect(m_prefetcher, &WeatherPrefetcher::snapshotUpdated,
+            this, &AppStateManager::scheduleWarmStartSave);
+
+    // 启动快照在状态稳定一段时间后再写
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(1000);
+    connect(&m_saveTimer, &QTimer::timeout, this, &AppStateManager::saveWarmStart);
+    connect(this, &AppStateManager::recentCitiesChanged, this, &AppStateManager::scheduleWarmStartSave);
+    connect(this, &AppStateManager::currentCityIndexChanged, this, &AppStateManager::scheduleWarmStartSave);
+    connect(this, &AppStateManager::currentViewModeChanged, this, &AppStateManager::scheduleWarmStartSave);
 }
 
-AppStateManager::~AppStateManager() = default;
+AppStateManager::~AppStateManager()
+{
+    // 还有未写入的变化时在退出前写入
+    if (m_saveTimer.isActive()) {
+        m_saveTimer.stop();
+        saveWarmStart();
+    }
+}
 
 void AppStateManager::setMaxCities(int maxCities){
     if(m_maxCities != maxCities && maxCities > 0){
@@ -26,14 +48,14 @@ void AppStateManager::setMaxCities(int maxCities){
         emit maxCitiesChanged();
     
         // 限制最大城市数量
-        if(m_recentCities.size() > m_maxCities){
-            m_recentCities = m_recentCities.mid(0, m_maxCities);
+        if(m_recentCities->rowCount() > m_maxCities){
+            m_recentCities->truncate(m_maxCities);
             emit recentCitiesChanged();
             //如果当前索引超出范围，重置
             if(m_currentCityIndex >= maxCities){
                 setCurrentCityIndex(0);
-                if(!m_recentCities.isEmpty()){
-                    setCurrentCity(m_recentCities.first().toMap());
+                if(m_recentCities->rowCount() > 0){
+                    setCurrentCity(m_recentCities->cityAt(0));
                 }
             }
         }
@@ -44,7 +66,10 @@ void AppStateManager::setMaxCities(int maxCities){
 void AppStateManager::initialize(){
     if(m_initialized) return ;
 
-    loadSampleData();
+    // 有启动快照时先用上次的数据绘制界面，再在后台刷新
+    if(!restoreWarmStart()){
+        loadSampleData();
+    }
     m_initialized = true;
     qDebug() << "AppStateManager initialized";
 }
@@ -68,7 +93,7 @@ void AppStateManager::setViewMode(const QString &viewMode){
         emit currentViewModeChanged();
         emit viewmodechanged(viewMode);
         
-        if(!m_weatherData.isEmpty()){
+        if(m_hasWeatherData){
             emit citychanged(getCurrentCityForView());
         }
     }
@@ -79,63 +104,45 @@ void AppStateManager::addToRecentCities(const QVariantMap &cityData)
     // 如果城市数据为空 或者城市数据里不包含城市名字
     if (cityData.isEmpty() || !cityData.contains("cityName")) return;
 
-    QString cityName = cityData["cityName"].toString();
-    QVariantList newCities = m_recentCities;
-    
-    // 检查是否已存在
-    int existingIndex = -1;
-    for (int i = 0; i < newCities.size(); ++i) {
-        QVariantMap city = newCities[i].toMap();
-        if (city["cityName"].toString() == cityName) {
-            existingIndex = i;
-            break;
-        }
-    }
-    
-    // 移除已存在的
-    if (existingIndex >= 0) {
-        newCities.removeAt(existingIndex);
-    }
-    
-    // 添加到最前面
-    newCities.prepend(cityData);
-    
-    // 保持最多maxCities个
-    if (newCities.size() > m_maxCities) {
-        newCities = newCities.mid(0, m_maxCities);
-    }
-    
-    m_recentCities = newCities;
+    // 已存在的城市移到最前面，否则插入到最前面并裁剪到maxCities个
+    // 模型按行发出移动/插入/删除通知，并用哈希查找已存在的城市
+    m_recentCities->touch(cityData["cityName"].toString(), cityData, m_maxCities);
+
     setCurrentCityIndex(0);
     emit recentCitiesChanged();//通知UI更新
     emit citiesListChanged();//通知其他业务逻辑
+    schedulePrefetch();
 }
 
 // AppStateManager 类的成员函数，用于切换到指定索引的城市
 void AppStateManager::switchToCity(int index){
     // 检查索引是否在有效范围内且与当前城市索引不同
-    if(index >= 0 && index < m_recentCities.size() && index != m_currentCityIndex){
+    if(index >= 0 && index < m_recentCities->rowCount() && index != m_currentCityIndex){
         // 设置当前城市索引为传入的索引值
         setCurrentCityIndex(index);
         // 更新当前城市数据为指定索引对应的城市数据
-        setCurrentCityInternal(m_recentCities[index].toMap());
+        setCurrentCityInternal(m_recentCities->cityAt(index));
         // 通知外部城市已更改，传递新的城市视图数据
         emit citychanged(getCurrentCityForView());
+        // 翻页后预热前后相邻的城市
+        schedulePrefetch();
     }
 }
 
 //切换到下一个城市
 void AppStateManager::switchToNext(){
-    if (!m_recentCities.isEmpty()) {
-        int newIndex = (m_currentCityIndex + 1) % m_recentCities.size();
+    const int count = m_recentCities->rowCount();
+    if (count > 0) {
+        int newIndex = (m_currentCityIndex + 1) % count;
         switchToCity(newIndex);
     }
 }
 
 //切换到上一个城市
 void AppStateManager::switchToPrevious(){
-    if (!m_recentCities.isEmpty()) {
-        int newIndex = (m_currentCityIndex - 1 + m_recentCities.size()) % m_recentCities.size();
+    const int count = m_recentCities->rowCount();
+    if (count > 0) {
+        int newIndex = (m_currentCityIndex - 1 + count) % count;
         switchToCity(newIndex);
     }
 }
@@ -150,132 +157,299 @@ QVariantMap AppStateManager::getCurrentCityForView(){
     QString cityName = m_currentCity["cityName"].toString();
     if(cityName.isEmpty()) return baseData;
 
-    if(m_currentViewMode == "temperature_trend"){
-        qDebug() << "getCurrentCityForView: temperature_trend mode, calling getWeeklyForecast for:" << cityName;
-        baseData["weeklyForecast"] = getWeeklyForecast(cityName);//来自Service
-    }else if(m_currentViewMode == "detailed_info"){
-        baseData["detailedInfo"] = getDetailedInfo(cityName);//来自Service
-    }else if(m_currentViewMode == "sunrise_info"){
-        baseData["sunriseInfo"] = getSunriseInfo(cityName);//来自Service
+    // 视图数据来自内存快照，切换标签页不发起网络请求
+    if(m_currentViewMode == WeatherSnapshotStore::kTrendView){
+        baseData["weeklyForecast"] = getWeeklyForecast(cityName);
+    }else if(m_currentViewMode == WeatherSnapshotStore::kDetailView){
+        baseData["detailedInfo"] = getDetailedInfo(cityName);
+    }else if(m_currentViewMode == WeatherSnapshotStore::kSunriseView){
+        baseData["sunriseInfo"] = getSunriseInfo(cityName);
+    }else{
+        refreshSnapshotIfStale(cityName);
     }
     return baseData;
 }
 
 QVariantMap AppStateManager::getWeeklyForecast(const QString &cityName)
 {
-    // 调用WeatherDataService获取每日天气预报（更准确的温度数据）
-    // 注意：这是一个同步调用的包装，实际的异步调用在WeatherDataService中处理
-    qDebug() << "getWeeklyForecast called for city:" << cityName;
-    
-    QVariantMap result;
-    result["cityName"] = cityName;
-    result["requestType"] = "weeklyForecast";
-    
-    // 触发异步请求 - 使用getDailyForecast获取更准确的每日温度数据
-    // WeatherDataService会通过dataLoaded信号返回数据，已在构造函数中连接到onWeatherDataLoaded槽
-    qDebug() << "Calling getDailyForecast for:" << cityName;
-    m_weatherService->getDailyForecast(cityName, QJSValue());
-    
-    return result;
+    return snapshotView(cityName, WeatherSnapshotStore::kTrendView, "weeklyForecast");
 }
 
 QVariantMap AppStateManager::getDetailedInfo(const QString &cityName)
 {
-    // 调用WeatherDataService获取详细天气信息
-    QVariantMap result;
-    result["cityName"] = cityName;
-    result["requestType"] = "detailedInfo";
-    
-    // 触发异步请求
-    m_weatherService->getDetailedWeatherInfo(cityName, QJSValue());
-    
-    return result;
+    return snapshotView(cityName, WeatherSnapshotStore::kDetailView, "detailedInfo");
 }
 
 QVariantMap AppStateManager::getSunriseInfo(const QString &cityName)
 {
-    // 调用WeatherDataService获取日出日落信息
-    QVariantMap result;
+    return snapshotView(cityName, WeatherSnapshotStore::kSunriseView, "sunriseInfo");
+}
+
+QVariantMap AppStateManager::snapshotView(const QString &cityName, const QString &viewMode, const QString &requestType)
+{
+    // 过期的快照照常返回，同时在后台刷新
+    refreshSnapshotIfStale(cityName);
+
+    QVariantMap result = m_snapshots.view(cityName, viewMode).value(requestType).toMap();
     result["cityName"] = cityName;
-    result["requestType"] = "sunriseInfo";
-    
-    // 触发异步请求
-    m_weatherService->getSunriseInfo(cityName, QJSValue());
-    
+    if (!m_snapshots.contains(cityName)) {
+        // 还没有快照：数据到达后通过citychanged推送
+        result["requestType"] = requestType;
+    }
     return result;
 }
 
+void AppStateManager::refreshSnapshotIfStale(const QString &cityName)
+{
+    if (!m_snapshots.needsRefresh(cityName) || !m_snapshots.beginRefresh(cityName)) {
+        return;
+    }
+
+    qDebug() << "Refreshing weather snapshot for:" << cityName;
+    m_refreshRequests.insert(cityName, 0);
+    const WeatherRequestId requestId = m_weatherService->fetchBundle(cityName, [this, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
+        m_refreshRequests.remove(cityName);
+        m_snapshots.endRefresh(cityName);
+        if (!bundle) {
+            qDebug() << "Snapshot refresh failed for" << cityName << error;
+            return;
+        }
+
+        // 结果按城市名写入快照；当前城市已经通过数据总线收到并重绘
+        m_snapshots.insert(cityName, bundle);
+        scheduleWarmStartSave();
+    });
+    // 命中缓存时回调已同步执行
+    if (m_refreshRequests.contains(cityName)) {
+        m_refreshRequests[cityName] = requestId;
+    }
+}
+
+void AppStateManager::subscribeToCity(const QString &cityName)
+{
+    if (cityName == m_subscribedCity) {
+        return;
+    }
+
+    // 只接收当前城市的数据，其他城市的响应（包括离开后迟到的）不会投递到这里
+    WeatherDataBus *bus = WeatherDataBus::shared();
+    bus->unsubscribe(m_cityBundleSubscription);
+    bus->unsubscribe(m_cityErrorSubscription);
+    m_subscribedCity = cityName;
+
+    // 快照仍在但总线上已没有该城市的数据包时重新发布，订阅时回放，切换后立即显示新城市的数据
+    const CityWeatherBundlePtr snapshot = m_snapshots.bundle(cityName);
+    if (snapshot && !bus->latest(cityName)) {
+        bus->publish(cityName, snapshot);
+    }
+    m_cityBundleSubscription = bus->subscribeBundle(cityName, this, [this, cityName](const CityWeatherBundlePtr &bundle) {
+        applyCurrentBundle(cityName, bundle);
+    }, true);
+    m_cityErrorSubscription = bus->subscribeErrors(cityName, this, [this, cityName](const QString &error) {
+        // 已有快照时继续显示旧数据
+        if (!m_snapshots.contains(cityName)) {
+            onWeatherDataError(error);
+        }
+    });
+}
+
+void AppStateManager::applyCurrentBundle(const QString &cityName, const CityWeatherBundlePtr &bundle)
+{
+    m_snapshots.insert(cityName, bundle);
+    scheduleWarmStartSave();
+
+    // 同步类型化状态并把新数据推给视图
+    m_conditions = bundle->current();
+    m_forecastDays = bundle->days();
+    m_weatherError.clear();
+    m_hasWeatherData = true;
+    notifyWeatherDataChanged();
+    emit citychanged(getCurrentCityForView());
+}
+
+void AppStateManager::schedulePrefetch()
+{
+    const int count = m_recentCities->rowCount();
+    if (count == 0) {
+        m_prefetcher->cancel();
+        return;
+    }
+
+    // 当前城市排在最前（通常已新鲜，只预热视图），然后是下一个、上一个
+    QStringList targets;
+    targets << m_recentCities->cityNameAt(m_currentCityIndex);
+    if (count > 1) {
+        targets << m_recentCities->cityNameAt((m_currentCityIndex + 1) % count);
+        targets << m_recentCities->cityNameAt((m_currentCityIndex - 1 + count) % count);
+    }
+    m_prefetcher->setTargets(targets);
+
+    // 用户已经离开的城市：取消前台刷新，迟到的响应不再占用带宽
+    const QStringList refreshing = m_refreshRequests.keys();
+    for (const QString &cityName : refreshing) {
+        if (!targets.contains(cityName)) {
+            m_weatherService->cancelRequest(m_refreshRequests.take(cityName));
+            m_snapshots.endRefresh(cityName);
+            qDebug() << "Cancelled snapshot refresh for:" << cityName;
+        }
+    }
+}
+
+void AppStateManager::prefetchView(const QString &viewMode)
+{
+    m_prefetcher->setLikelyView(viewMode);
+    schedulePrefetch();
+}
+
+bool AppStateManager::restoreWarmStart()
+{
+    WarmStartState state;
+    if (!WarmStartFile::load(WarmStartFile::defaultPath(), &state) || state.cities.isEmpty()) {
+        return false;
+    }
+
+    // 天气数据按原来的获取时刻放入快照存储，过期的会在下面触发后台刷新
+    for (const WarmStartState::Snapshot &snapshot : state.snapshots) {
+        m_snapshots.insert(snapshot.cityName, CityWeatherBundle::fromConditions(snapshot.conditions),
+                           snapshot.fetchedAtMs);
+    }
+
+    // 从最旧的城市开始插入，最终顺序与保存时一致
+    m_recentCities->clear();
+    for (auto it = state.cities.crbegin(); it != state.cities.crend(); ++it) {
+        m_recentCities->touch(it->name, it->data, m_maxCities);
+    }
+    emit recentCitiesChanged();
+    emit citiesListChanged();
+
+    if (!state.viewMode.isEmpty() && state.viewMode != m_currentViewMode) {
+        m_currentViewMode = state.viewMode;
+        emit currentViewModeChanged();
+    }
+
+    const int index = qBound(0, state.currentIndex, m_recentCities->rowCount() - 1);
+    setCurrentCityIndex(index);
+    setCurrentCityInternal(m_recentCities->cityAt(index));
+
+    const QString cityName = m_recentCities->cityNameAt(index);
+    qDebug() << "Restored warm start state with" << m_recentCities->rowCount() << "cities, current:" << cityName;
+    // 恢复的数据包发布到数据总线：当前城市的订阅者立即绘制，其他城市供之后订阅时回放
+    for (const WarmStartState::Snapshot &snapshot : state.snapshots) {
+        if (const CityWeatherBundlePtr bundle = m_snapshots.bundle(snapshot.cityName)) {
+            WeatherDataBus::shared()->publish(snapshot.cityName, bundle);
+        }
+    }
+    refreshSnapshotIfStale(cityName);
+    schedulePrefetch();
+    return true;
+}
+
+void AppStateManager::saveWarmStart()
+{
+    WarmStartState state;
+    state.viewMode = m_currentViewMode;
+    state.currentIndex = m_currentCityIndex;
+
+    const int count = m_recentCities->rowCount();
+    for (int row = 0; row < count; ++row) {
+        const QString cityName = m_recentCities->cityNameAt(row);
+        state.cities.append({cityName, m_recentCities->cityAt(row)});
+        // 只保存最近城市的天气数据
+        if (const CityWeatherBundlePtr bundle = m_snapshots.bundle(cityName)) {
+            state.snapshots.append({cityName, bundle->current(), m_snapshots.fetchedAt(cityName)});
+        }
+    }
+
+    if (!WarmStartFile::save(WarmStartFile::defaultPath(), state)) {
+        qWarning() << "Failed to save warm start state";
+    }
+}
+
+void AppStateManager::scheduleWarmStartSave()
+{
+    // 恢复过程中的变化不需要写回
+    if (m_initialized) {
+        m_saveTimer.start();
+    }
+}
+
 void AppStateManager::loadSampleData()
 {
     // TODO: 删除示例数据，改为从真实API加载数据
-    QVariantList emptyCities;
-    m_recentCities = emptyCities;
+    m_recentCities->clear();
     emit recentCitiesChanged();
     emit citiesListChanged();
 }
 
-void AppStateManager::onWeatherDataLoaded(const QVariantMap &data)
+QVariantMap AppStateManager::weatherData() const
 {
-    // 处理从WeatherDataService接收到的天气数据
-    QVariantMap processedData = data;
-    
-    // 如果数据包含forecast数组，转换为前端期望的weeklyForecast格式
-    if (data.contains("forecast") && data["forecast"].canConvert<QVariantList>()) {
-        QVariantList forecastList = data["forecast"].toList();
-        
-        QVariantMap weeklyForecast;
-        QVariantList recentDaysName;
-        QVariantList recentDaysMaxMinTempreture;
-        QVariantList recentDaysWeatherDescriptionIcon;
-        
-        for (const QVariant &item : forecastList) {
-            QVariantMap dayData = item.toMap();
-            
-            // 添加日期名称
-            recentDaysName.append(dayData.value("date", "").toString());
-            
-            // 添加最高最低温度
-            QString tempStr = QString("%1°/%2°")
-                .arg(dayData.value("maxTemp", 0).toInt())
-                .arg(dayData.value("minTemp", 0).toInt());
-            recentDaysMaxMinTempreture.append(tempStr);
-            
-            // 添加天气图标和描述
-            QString iconDesc = QString("%1 %2")
-                .arg(dayData.value("icon", "").toString())
-                .arg(dayData.value("description", "").toString());
-            recentDaysWeatherDescriptionIcon.append(iconDesc);
+    if (m_weatherDataCacheValid) {
+        return m_weatherDataCache;
+    }
+
+    QVariantMap data;
+    if (!m_weatherError.isEmpty()) {
+        data["error"] = m_weatherError;
+        data["hasError"] = true;
+    } else if (m_hasWeatherData) {
+        data = m_conditions.toVariantMap();
+
+        // 有单独加载的预报时，转换为前端期望的weeklyForecast格式
+        if (!m_forecastDays.isEmpty()) {
+            QVariantMap weeklyForecast;
+            QVariantList recentDaysName;
+            QVariantList recentDaysMaxMinTempreture;
+            QVariantList recentDaysWeatherDescriptionIcon;
+            QVariantList recentDaysHigh;
+            QVariantList recentDaysLow;
+
+            for (const DailyForecast &day : m_forecastDays) {
+                recentDaysName.append(day.date);
+                recentDaysMaxMinTempreture.append(day.maxMinText());
+                recentDaysWeatherDescriptionIcon.append(day.icon + " " + day.type);
+                recentDaysHigh.append(day.hasTemperature ? QVariant(day.highTemp) : QVariant());
+                recentDaysLow.append(day.hasTemperature ? QVariant(day.lowTemp) : QVariant());
+            }
+
+            weeklyForecast["recentDaysName"] = recentDaysName;
+            weeklyForecast["recentDaysMaxMinTempreture"] = recentDaysMaxMinTempreture;
+            weeklyForecast["recentDaysWeatherDescriptionIcon"] = recentDaysWeatherDescriptionIcon;
+            weeklyForecast["recentDaysHigh"] = recentDaysHigh;
+            weeklyForecast["recentDaysLow"] = recentDaysLow;
+            data["weeklyForecast"] = weeklyForecast;
+            data["forecast"] = forecastToVariantList(m_forecastDays);
         }
-        
-        weeklyForecast["recentDaysName"] = recentDaysName;
-        weeklyForecast["recentDaysMaxMinTempreture"] = recentDaysMaxMinTempreture;
-        weeklyForecast["recentDaysWeatherDescriptionIcon"] = recentDaysWeatherDescriptionIcon;
-        
-        processedData["weeklyForecast"] = weeklyForecast;
-        
-        qDebug() << "Processed forecast data with" << forecastList.size() << "days";
     }
-    
-    m_weatherData = processedData;
-    emit weatherDataChanged();
-    emit weatherDataUpdated(processedData);
+
+    m_weatherDataCache = data;
+    m_weatherDataCacheValid = true;
+    return m_weatherDataCache;
 }
 
 void AppStateManager::onWeatherDataError(const QString &error)
 {
     // 处理天气数据加载错误
-    QVariantMap errorData;
-    errorData["error"] = error;
-    errorData["hasError"] = true;
-    
-    m_weatherData = errorData;
+    m_weatherError = error;
+    m_hasWeatherData = true;
+    m_weatherDataCacheValid = false;
     emit weatherDataChanged();
 }
 
+void AppStateManager::notifyWeatherDataChanged()
+{
+    m_weatherDataCacheValid = false;
+    emit weatherDataChanged();
+    // 没有接收者时不做转换
+    if (isSignalConnected(QMetaMethod::fromSignal(&AppStateManager::weatherDataUpdated))) {
+        emit weatherDataUpdated(weatherData());
+    }
+}
+
 void AppStateManager::setCurrentCityInternal(const QVariantMap &cityData)
 {
     if (m_currentCity != cityData) {
         m_currentCity = cityData;
+        subscribeToCity(cityData.value("cityName").toString());
         emit currentCityChanged();
     }
 }
@@ -0,0 +1,147 @@
+#include "../../include/commonDataType/CityWeatherBundle.hpp"
+#include <QJsonArray>
+#include <QDebug>
+
+CityWeatherBundlePtr CityWeatherBundle::fromJson(const QJsonObject &json)
+{
+    std::shared_ptr<CityWeatherBundle> bundle(new CityWeatherBundle);
+
+    QJsonObject data = json.value("data").toObject();
+    QJsonObject cityInfo = json.value("cityInfo").toObject();
+    QJsonArray forecast = data.value("forecast").toArray();
+
+    CurrentConditions &current = bundle->m_current;
+    current.cityName = cityInfo.value("city").toString();
+
+    // 预报列表：只遍历一次
+    current.forecast.reserve(forecast.size());
+    for (const QJsonValue &value : forecast) {
+        QJsonObject dayData = value.toObject();
+        DailyForecast day;
+        day.date = dayData.value("ymd").toString();
+        day.week = dayData.value("week").toString();
+        day.high = dayData.value("high").toString();
+        day.low = dayData.value("low").toString();
+        // 数值温度在这里提取一次，界面和图表直接使用整数
+        day.hasTemperature = DailyForecast::temperatureFromText(day.high, &day.highTemp)
+                             && DailyForecast::temperatureFromText(day.low, &day.lowTemp);
+        day.type = dayData.value("type").toString();
+        day.icon = iconForType(day.type);
+        day.windDirection = dayData.value("fx").toString();
+        day.windPower = dayData.value("fl").toString();
+        day.sunrise = dayData.value("sunrise").toString();
+        day.sunset = dayData.value("sunset").toString();
+        day.notice = dayData.value("notice").toString();
+        current.forecast.append(std::move(day));
+    }
+    const DailyForecast today = current.forecast.value(0);
+
+    // 今日天气：数值字段在这里解析一次
+    bool temperatureOk = false;
+    const double temperature = data.value("wendu").toString().toDouble(&temperatureOk);
+    if (temperatureOk) {
+        current.temperature = temperature;
+    }
+    current.type = today.type;
+    current.icon = today.icon;
+    current.ganmao = data.value("ganmao").toString();
+    current.notice = today.notice;
+
+    // 详细信息
+    WeatherDetails &details = current.details;
+    QString shidu = data.value("shidu").toString();
+    shidu.remove(u'%');
+    bool humidityOk = false;
+    const int humidity = shidu.toInt(&humidityOk);
+    details.humidity = humidityOk ? humidity : -1;
+    if (data.contains("pm25")) {
+        details.pm25 = data.value("pm25").toDouble();
+    }
+    details.airQuality = data.value("quality").toString();
+    details.windDirection = today.windDirection;
+    details.windPower = today.windPower;
+    details.uvIndex = "中等"; // 接口不提供紫外线强度，使用默认值
+
+    // 日出日落
+    current.sun = SunTimes::fromText(today.sunrise, today.sunset);
+
+    qDebug() << "Parsed weather bundle for" << current.cityName << "with" << forecast.size() << "forecast days";
+
+    return bundle;
+}
+
+CityWeatherBundlePtr CityWeatherBundle::fromConditions(const CurrentConditions &conditions)
+{
+    std::shared_ptr<CityWeatherBundle> bundle(new CityWeatherBundle);
+    bundle->m_current = conditions;
+    return bundle;
+}
+
+QVariantMap CityWeatherBundle::weeklyForecast() const
+{
+    // 温度趋势视图需要的并列数组
+    QVariantList recentDaysName;
+    QVariantList recentDaysMaxMinTempreture;
+    QVariantList recentDaysWeatherDescriptionIcon;
+    QVariantList recentDaysHigh;
+    QVariantList recentDaysLow;
+    QVariantList trendForecastList;
+
+    const qsizetype dayCount = qMin<qsizetype>(m_current.forecast.size(), kTrendDays);
+    for (qsizetype i = 0; i < dayCount; ++i) {
+        const DailyForecast &day = m_current.forecast.at(i);
+        // 格式化日期显示
+        if (i == 0) {
+            recentDaysName.append("今天");
+        } else if (i == 1) {
+            recentDaysName.append("明天");
+        } else {
+            recentDaysName.append(day.week);
+        }
+        recentDaysMaxMinTempreture.append(day.maxMinText());
+        recentDaysWeatherDescriptionIcon.append(day.icon);
+        recentDaysHigh.append(day.hasTemperature ? QVariant(day.highTemp) : QVariant());
+        recentDaysLow.append(day.hasTemperature ? QVariant(day.lowTemp) : QVariant());
+        trendForecastList.append(day.toVariantMap());
+    }
+
+    QVariantMap trendArrays;
+    trendArrays["recentDaysName"] = recentDaysName;
+    trendArrays["recentDaysMaxMinTempreture"] = recentDaysMaxMinTempreture;
+    trendArrays["recentDaysWeatherDescriptionIcon"] = recentDaysWeatherDescriptionIcon;
+    trendArrays["recentDaysHigh"] = recentDaysHigh;
+    trendArrays["recentDaysLow"] = recentDaysLow;
+
+    QVariantMap weekly;
+    weekly["cityName"] = m_current.cityName;
+    weekly["weeklyForecast"] = trendArrays;
+    weekly["forecast"] = trendForecastList;
+    return weekly;
+}
+
+QVariantMap CityWeatherBundle::detailedInfo() const
+{
+    // 详细信息：在今日天气基础上标记
+    QVariantMap detailed = m_current.toVariantMap();
+    detailed["isDetailed"] = true;
+    return detailed;
+}
+
+QVariantMap CityWeatherBundle::sunriseInfo() const
+{
+    QVariantMap sunrise = m_current.sun.toVariantMap();
+    sunrise["cityName"] = m_current.cityName;
+    return sunrise;
+}
+
+QString CityWeatherBundle::iconForType(const QString &type)
+{
+    if (type.contains("晴")) return "☀️";
+    if (type.contains("多云")) return "☁️";
+    if (type.contains("阴")) return "☁️";
+    if (type.contains("雨")) return "🌧️";
+    if (type.contains("雪")) return "❄️";
+    if (type.contains("雾")) return "🌫️";
+    if (type.contains("雷")) return "⛈️";
+    return "🌤️"; // 默认图标
+}
@@ -0,0 +1,186 @@
+#include "../../include/models/ForecastListModel.hpp"
+
+ForecastListModel::ForecastListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int ForecastListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+QVariant ForecastListModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid)) {
+        return QVariant();
+    }
+
+    const Row &row = m_rows.at(index.row());
+    switch (role) {
+    case DateRole: return row.date;
+    case WeekdayRole: return row.weekday;
+    case Qt::DisplayRole:
+    case DayLabelRole: return row.dayLabel;
+    case HighRole: return row.high;
+    case LowRole: return row.low;
+    case HasTemperatureRole: return row.hasTemperature;
+    case MaxMinTextRole: return row.maxMinText;
+    case TypeRole: return row.type;
+    case ConditionRole: return int(row.condition);
+    case IconRole: return row.icon;
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ForecastListModel::roleNames() const
+{
+    static const QHash<int, QByteArray> roles {
+        {DateRole, "date"},
+        {WeekdayRole, "weekday"},
+        {DayLabelRole, "dayLabel"},
+        {HighRole, "high"},
+        {LowRole, "low"},
+        {HasTemperatureRole, "hasTemperature"},
+        {MaxMinTextRole, "maxMinText"},
+        {TypeRole, "type"},
+        {ConditionRole, "condition"},
+        {IconRole, "icon"},
+    };
+    return roles;
+}
+
+QList<int> ForecastListModel::highs() const
+{
+    QList<int> values;
+    values.reserve(m_rows.size());
+    for (const Row &row : m_rows) {
+        if (row.hasTemperature) values.append(row.high);
+    }
+    return values;
+}
+
+QList<int> ForecastListModel::lows() const
+{
+    QList<int> values;
+    values.reserve(m_rows.size());
+    for (const Row &row : m_rows) {
+        if (row.hasTemperature) values.append(row.low);
+    }
+    return values;
+}
+
+QStringList ForecastListModel::dayLabels() const
+{
+    QStringList labels;
+    labels.reserve(m_rows.size());
+    for (const Row &row : m_rows) {
+        if (row.hasTemperature) labels.append(row.dayLabel);
+    }
+    return labels;
+}
+
+void ForecastListModel::setForecast(const QList<DailyForecast> &days)
+{
+    const qsizetype newCount = qMin<qsizetype>(days.size(), kMaxDays);
+    const qsizetype oldCount = m_rows.size();
+    bool temperaturesDirty = newCount != oldCount;
+
+    // 公共部分逐行比较，只通知变化的行和角色
+    const qsizetype common = qMin(oldCount, newCount);
+    for (qsizetype i = 0; i < common; ++i) {
+        Row row = makeRow(days.at(i), i);
+        const QList<int> roles = changedRoles(m_rows.at(i), row);
+        if (roles.isEmpty()) {
+            continue;
+        }
+        m_rows[i] = std::move(row);
+        const QModelIndex changed = index(int(i));
+        emit dataChanged(changed, changed, roles);
+        temperaturesDirty = temperaturesDirty || roles.contains(HighRole) || roles.contains(LowRole)
+                            || roles.contains(HasTemperatureRole) || roles.contains(DayLabelRole);
+    }
+
+    // 行数变化只影响末尾
+    if (newCount > oldCount) {
+        beginInsertRows(QModelIndex(), int(oldCount), int(newCount - 1));
+        for (qsizetype i = oldCount; i < newCount; ++i) {
+            m_rows.append(makeRow(days.at(i), i));
+        }
+        endInsertRows();
+        emit countChanged();
+    } else if (newCount < oldCount) {
+        beginRemoveRows(QModelIndex(), int(newCount), int(oldCount - 1));
+        m_rows.resize(newCount);
+        endRemoveRows();
+        emit countChanged();
+    }
+
+    if (temperaturesDirty) {
+        emit temperaturesChanged();
+    }
+}
+
+void ForecastListModel::clear()
+{
+    if (m_rows.isEmpty()) {
+        return;
+    }
+    beginResetModel();
+    m_rows.clear();
+    endResetModel();
+    emit countChanged();
+    emit temperaturesChanged();
+}
+
+ForecastListModel::Condition ForecastListModel::conditionForType(const QString &type)
+{
+    // 与CityWeatherBundle::iconForType的判断顺序一致
+    if (type.contains("晴")) return Sunny;
+    if (type.contains("多云")) return Cloudy;
+    if (type.contains("阴")) return Overcast;
+    if (type.contains("雨")) return Rain;
+    if (type.contains("雪")) return Snow;
+    if (type.contains("雾")) return Fog;
+    if (type.contains("雷")) return Thunder;
+    return Unknown;
+}
+
+ForecastListModel::Row ForecastListModel::makeRow(const DailyForecast &day, qsizetype index)
+{
+    Row row;
+    row.date = day.date;
+    row.weekday = day.week;
+    if (index == 0) {
+        row.dayLabel = "今天";
+    } else if (index == 1) {
+        row.dayLabel = "明天";
+    } else {
+        row.dayLabel = day.week;
+    }
+    // 整数温度已在解析时提取
+    row.high = day.highTemp;
+    row.low = day.lowTemp;
+    row.hasTemperature = day.hasTemperature;
+    row.maxMinText = day.maxMinText();
+    row.type = day.type;
+    row.condition = conditionForType(day.type);
+    row.icon = day.icon;
+    return row;
+}
+
+QList<int> ForecastListModel::changedRoles(const Row &before, const Row &after)
+{
+    QList<int> roles;
+    if (before.date != after.date) roles.append(DateRole);
+    if (before.weekday != after.weekday) roles.append(WeekdayRole);
+    if (before.dayLabel != after.dayLabel) roles << DayLabelRole << Qt::DisplayRole;
+    if (before.high != after.high) roles.append(HighRole);
+    if (before.low != after.low) roles.append(LowRole);
+    if (before.hasTemperature != after.hasTemperature) roles.append(HasTemperatureRole);
+    if (before.maxMinText != after.maxMinText) roles.append(MaxMinTextRole);
+    if (before.type != after.type) roles.append(TypeRole);
+    if (before.condition != after.condition) roles.append(ConditionRole);
+    if (before.icon != after.icon) roles.append(IconRole);
+    return roles;
+}
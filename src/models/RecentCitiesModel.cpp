@@ -0,0 +1,144 @@
+#include "../../include/models/RecentCitiesModel.hpp"
+
+RecentCitiesModel::RecentCitiesModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int RecentCitiesModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_cities.size());
+}
+
+QVariant RecentCitiesModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid)) {
+        return QVariant();
+    }
+
+    const City &city = m_cities.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case CityNameRole: return city.name;
+    case CityDataRole: return city.data;
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> RecentCitiesModel::roleNames() const
+{
+    static const QHash<int, QByteArray> roles {
+        {CityNameRole, "cityName"},
+        {CityDataRole, "cityData"},
+    };
+    return roles;
+}
+
+int RecentCitiesModel::indexOf(const QString &cityName) const
+{
+    return int(m_rowByName.value(cityName, -1));
+}
+
+QString RecentCitiesModel::cityNameAt(int row) const
+{
+    return row >= 0 && row < m_cities.size() ? m_cities.at(row).name : QString();
+}
+
+QVariantMap RecentCitiesModel::cityAt(int row) const
+{
+    return row >= 0 && row < m_cities.size() ? m_cities.at(row).data : QVariantMap();
+}
+
+void RecentCitiesModel::touch(const QString &cityName, const QVariantMap &cityData, int maxCount)
+{
+    if (cityName.isEmpty() || maxCount <= 0) {
+        return;
+    }
+
+    const qsizetype existing = m_rowByName.value(cityName, -1);
+    if (existing == 0) {
+        // 已经在第一行，只更新数据
+        if (m_cities.first().data != cityData) {
+            m_cities.first().data = cityData;
+            const QModelIndex changed = index(0);
+            emit dataChanged(changed, changed, {CityDataRole});
+        }
+        return;
+    }
+
+    if (existing > 0) {
+        // 移到第一行，只有[0, existing]范围内的行号变化
+        beginMoveRows(QModelIndex(), int(existing), int(existing), QModelIndex(), 0);
+        m_cities.move(existing, 0);
+        endMoveRows();
+        reindex(0, existing);
+        if (m_cities.first().data != cityData) {
+            m_cities.first().data = cityData;
+            const QModelIndex changed = index(0);
+            emit dataChanged(changed, changed, {CityDataRole});
+        }
+        return;
+    }
+
+    const qsizetype oldCount = m_cities.size();
+    beginInsertRows(QModelIndex(), 0, 0);
+    m_cities.prepend(City{cityName, cityData});
+    endInsertRows();
+    reindex(0, m_cities.size() - 1);
+    removeTail(maxCount);
+    if (m_cities.size() != oldCount) {
+        emit countChanged();
+    }
+}
+
+void RecentCitiesModel::truncate(int maxCount)
+{
+    if (removeTail(maxCount)) {
+        emit countChanged();
+    }
+}
+
+bool RecentCitiesModel::removeTail(int maxCount)
+{
+    const qsizetype keep = qMax(0, maxCount);
+    if (m_cities.size() <= keep) {
+        return false;
+    }
+
+    beginRemoveRows(QModelIndex(), int(keep), int(m_cities.size() - 1));
+    for (qsizetype i = keep; i < m_cities.size(); ++i) {
+        m_rowByName.remove(m_cities.at(i).name);
+    }
+    m_cities.resize(keep);
+    endRemoveRows();
+    return true;
+}
+
+void RecentCitiesModel::clear()
+{
+    if (m_cities.isEmpty()) {
+        return;
+    }
+    beginResetModel();
+    m_cities.clear();
+    m_rowByName.clear();
+    endResetModel();
+    emit countChanged();
+}
+
+QVariantList RecentCitiesModel::toVariantList() const
+{
+    QVariantList list;
+    list.reserve(m_cities.size());
+    for (const City &city : m_cities) {
+        list.append(city.data);
+    }
+    return list;
+}
+
+void RecentCitiesModel::reindex(qsizetype first, qsizetype last)
+{
+    for (qsizetype i = first; i <= last && i < m_cities.size(); ++i) {
+        m_rowByName.insert(m_cities.at(i).name, i);
+    }
+}
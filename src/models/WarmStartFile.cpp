@@ -0,0 +1,107 @@
+#include "../../include/models/WarmStartFile.hpp"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+namespace {
+
+// 流格式固定，不随运行时的Qt版本变化
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_6_4;
+
+}
+
+QString WarmStartFile::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/warmstart.bin";
+}
+
+bool WarmStartFile::save(const QString &path, const WarmStartState &state)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write warm start file:" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    out << kMagic << kVersion;
+    out << state.viewMode << qint32(state.currentIndex);
+
+    out << quint32(state.cities.size());
+    for (const WarmStartState::City &city : state.cities) {
+        out << city.name << city.data;
+    }
+
+    out << quint32(state.snapshots.size());
+    for (const WarmStartState::Snapshot &snapshot : state.snapshots) {
+        out << snapshot.cityName << snapshot.fetchedAtMs << snapshot.conditions;
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    // 写完后一次性替换旧文件
+    return file.commit();
+}
+
+bool WarmStartFile::load(const QString &path, WarmStartState *state)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0) {
+        return false;
+    }
+
+    uchar *mapped = file.map(0, file.size());
+    if (!mapped) {
+        return false;
+    }
+    // 直接在映射的内存上解码，字符串在读取时才各自分配
+    const QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), file.size());
+
+    QDataStream in(raw);
+    in.setVersion(kStreamVersion);
+
+    WarmStartState loaded;
+    bool ok = false;
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic == kMagic && version == kVersion) {
+        qint32 currentIndex = 0;
+        in >> loaded.viewMode >> currentIndex;
+        loaded.currentIndex = currentIndex;
+
+        quint32 cityCount = 0;
+        in >> cityCount;
+        for (quint32 i = 0; i < cityCount && in.status() == QDataStream::Ok; ++i) {
+            WarmStartState::City city;
+            in >> city.name >> city.data;
+            loaded.cities.append(std::move(city));
+        }
+
+        quint32 snapshotCount = 0;
+        in >> snapshotCount;
+        for (quint32 i = 0; i < snapshotCount && in.status() == QDataStream::Ok; ++i) {
+            WarmStartState::Snapshot snapshot;
+            in >> snapshot.cityName >> snapshot.fetchedAtMs >> snapshot.conditions;
+            loaded.snapshots.append(std::move(snapshot));
+        }
+        ok = in.status() == QDataStream::Ok;
+    } else {
+        qDebug() << "Ignoring warm start file with unknown format:" << path;
+    }
+
+    file.unmap(mapped);
+    if (ok) {
+        *state = std::move(loaded);
+    }
+    return ok;
+}
@@ -8,6 +8,9 @@ WeatherDataModel::WeatherDataModel(QObject *parent) : QObject(parent)
     , m_weatherIcon("🌤️")
     , m_weatherDescription("未知")
     , m_maxMinTemp("--°C / --°C")
+    , m_highTemperature(0)
+    , m_lowTemperature(0)
+    , m_hasTemperatureRange(false)
     , m_ganmao("")
     , m_notice("")
 {
@@ -147,6 +150,12 @@ WeatherDataModel* WeatherDataModel::fromRawData(const QVariantMap& rawData, QObj
     return model;  
 }
 
+WeatherDataModel* WeatherDataModel::fromConditions(const CurrentConditions &conditions, QObject *parent){
+    auto model = new WeatherDataModel(parent);
+    model->updateData(conditions);
+    return model;
+}
+
 WeatherDataModel* WeatherDataModel::createEmpty(QObject *parent){
    auto model = new WeatherDataModel(parent);
    
@@ -171,6 +180,10 @@ QVariantMap WeatherDataModel::toObject() const{
         obj["weatherIcon"] = m_weatherIcon;
         obj["weatherDescription"] = m_weatherDescription;
         obj["maxMinTemp"] = m_maxMinTemp;
+        if (m_hasTemperatureRange) {
+            obj["highTemperature"] = m_highTemperature;
+            obj["lowTemperature"] = m_lowTemperature;
+        }
         obj["weeklyForecast"] = m_weeklyForecast;
         obj["detailedInfo"] = m_detailedInfo;
         obj["sunriseInfo"] = m_sunriseInfo;
@@ -220,3 +233,46 @@ void WeatherDataModel::updateData(const QVariantMap &newData){
     }
 }
 
+bool WeatherDataModel::updateData(const CurrentConditions &conditions){
+    // 温度趋势视图使用的并列数组，直接从类型化预报生成
+    QVariantMap weeklyForecastMap;
+    QVariantList recentDaysName;
+    QVariantList recentDaysMaxMinTempreture;
+    QVariantList recentDaysWeatherDescriptionIcon;
+    QVariantList recentDaysHigh;
+    QVariantList recentDaysLow;
+    for (qsizetype i = 0; i < conditions.forecast.size(); ++i) {
+        const DailyForecast &day = conditions.forecast.at(i);
+        recentDaysName.append(day.week);
+        recentDaysMaxMinTempreture.append(day.maxMinText());
+        recentDaysWeatherDescriptionIcon.append(day.type);
+        recentDaysHigh.append(day.hasTemperature ? QVariant(day.highTemp) : QVariant());
+        recentDaysLow.append(day.hasTemperature ? QVariant(day.lowTemp) : QVariant());
+        weeklyForecastMap[QString::number(i)] = day.toVariantMap();
+    }
+    weeklyForecastMap["recentDaysName"] = recentDaysName;
+    weeklyForecastMap["recentDaysMaxMinTempreture"] = recentDaysMaxMinTempreture;
+    weeklyForecastMap["recentDaysWeatherDescriptionIcon"] = recentDaysWeatherDescriptionIcon;
+    weeklyForecastMap["recentDaysHigh"] = recentDaysHigh;
+    weeklyForecastMap["recentDaysLow"] = recentDaysLow;
+    const DailyForecast today = conditions.forecast.value(0);
+
+    // 逐个比较，同一城市的重复刷新通常只有温度等少数属性会发出通知
+    bool changed = false;
+    changed |= assign(m_cityName, conditions.cityName, &WeatherDataModel::cityNameChanged);
+    changed |= assign(m_temperature, conditions.temperatureText(), &WeatherDataModel::temperatureChanged);
+    changed |= assign(m_weatherIcon, conditions.icon.isEmpty() ? QStringLiteral("🌤️") : conditions.icon,
+                      &WeatherDataModel::weatherIconChanged);
+    changed |= assign(m_weatherDescription, conditions.type.isEmpty() ? QStringLiteral("未知") : conditions.type,
+                      &WeatherDataModel::weatherDescriptionChanged);
+    changed |= assign(m_maxMinTemp, conditions.maxMinTemp(), &WeatherDataModel::maxMinTempChanged);
+    changed |= assign(m_highTemperature, today.highTemp, &WeatherDataModel::highTemperatureChanged);
+    changed |= assign(m_lowTemperature, today.lowTemp, &WeatherDataModel::lowTemperatureChanged);
+    changed |= assign(m_hasTemperatureRange, today.hasTemperature, &WeatherDataModel::hasTemperatureRangeChanged);
+    changed |= assign(m_weeklyForecast, weeklyForecastMap, &WeatherDataModel::weeklyForecastChanged);
+    changed |= assign(m_detailedInfo, conditions.details.toVariantMap(), &WeatherDataModel::detailedInfoChanged);
+    changed |= assign(m_sunriseInfo, conditions.sun.toVariantMap(), &WeatherDataModel::sunriseInfoChanged);
+    changed |= assign(m_ganmao, conditions.ganmao, &WeatherDataModel::ganmaoChanged);
+    changed |= assign(m_notice, conditions.notice, &WeatherDataModel::noticeChanged);
+    return changed;
+}
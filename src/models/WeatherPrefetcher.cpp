@@ -0,0 +1,111 @@
+#include "../../include/models/WeatherPrefetcher.hpp"
+#include "../../include/models/WeatherSnapshotStore.hpp"
+#include "../../include/services/WeatherDataService.hpp"
+#include <QDebug>
+
+WeatherPrefetcher::WeatherPrefetcher(WeatherSnapshotStore *store, WeatherDataService *service, QObject *parent)
+    : QObject(parent)
+    , m_store(store)
+    , m_service(service)
+    , m_maxInFlight(kDefaultMaxInFlight)
+{
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(kDefaultIdleDelayMs);
+    connect(&m_idleTimer, &QTimer::timeout, this, &WeatherPrefetcher::pump);
+}
+
+void WeatherPrefetcher::setTargets(const QStringList &cityNames, const QString &likelyView)
+{
+    // 新目标替换旧队列：用户已经离开的位置不再预取
+    m_queue.clear();
+    for (const QString &cityName : cityNames) {
+        if (!cityName.isEmpty() && !m_queue.contains(cityName)) {
+            m_queue.append(cityName);
+        }
+    }
+    // 用户已经离开的城市：中止进行中的请求，把带宽让给新的目标
+    const QStringList inFlight = m_inFlight.keys();
+    for (const QString &cityName : inFlight) {
+        if (!m_queue.contains(cityName)) {
+            abort(cityName);
+        }
+    }
+    if (!likelyView.isEmpty()) {
+        m_likelyView = likelyView;
+    }
+    // 连续翻页时重新计时，只在停下后开始
+    m_idleTimer.start();
+}
+
+void WeatherPrefetcher::setLikelyView(const QString &viewMode)
+{
+    if (m_likelyView == viewMode) {
+        return;
+    }
+    m_likelyView = viewMode;
+    m_idleTimer.start();
+}
+
+void WeatherPrefetcher::cancel()
+{
+    m_idleTimer.stop();
+    m_queue.clear();
+    const QStringList inFlight = m_inFlight.keys();
+    for (const QString &cityName : inFlight) {
+        abort(cityName);
+    }
+}
+
+void WeatherPrefetcher::abort(const QString &cityName)
+{
+    const WeatherRequestId requestId = m_inFlight.take(cityName);
+    m_service->cancelRequest(requestId);
+    m_store->endRefresh(cityName);
+    qDebug() << "Cancelled prefetch for:" << cityName;
+}
+
+void WeatherPrefetcher::pump()
+{
+    while (m_inFlight.size() < m_maxInFlight && !m_queue.isEmpty()) {
+        const QString cityName = m_queue.takeFirst();
+        if (!m_store->needsRefresh(cityName)) {
+            // 快照新鲜（或已有请求在进行）：只预热下一个视图
+            warmView(cityName);
+            continue;
+        }
+        fetch(cityName);
+    }
+}
+
+void WeatherPrefetcher::fetch(const QString &cityName)
+{
+    if (!m_store->beginRefresh(cityName)) {
+        return;
+    }
+
+    qDebug() << "Prefetching weather snapshot for:" << cityName;
+    m_inFlight.insert(cityName, 0);
+    const WeatherRequestId requestId = m_service->fetchBundle(cityName, [this, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
+        m_inFlight.remove(cityName);
+        m_store->endRefresh(cityName);
+        if (bundle) {
+            m_store->insert(cityName, bundle);
+            warmView(cityName);
+            emit snapshotUpdated(cityName);
+        } else {
+            qDebug() << "Prefetch failed for" << cityName << error;
+        }
+        pump();
+    });
+    // 命中缓存时回调已在上面同步执行
+    if (m_inFlight.contains(cityName)) {
+        m_inFlight[cityName] = requestId;
+    }
+}
+
+void WeatherPrefetcher::warmView(const QString &cityName)
+{
+    if (!m_likelyView.isEmpty() && m_store->contains(cityName)) {
+        m_store->view(cityName, m_likelyView);
+    }
+}
@@ -0,0 +1,99 @@
+#include "../../include/models/WeatherSnapshotStore.hpp"
+#include <QDateTime>
+
+WeatherSnapshotStore::WeatherSnapshotStore(int maxCities, int freshMs)
+    : m_entries(maxCities)
+    , m_freshMs(freshMs)
+{
+}
+
+void WeatherSnapshotStore::insert(const QString &cityName, const CityWeatherBundlePtr &bundle, qint64 fetchedAtMs)
+{
+    if (cityName.isEmpty() || !bundle) return;
+    // 同一个数据包（例如多条路径拿到同一个缓存结果）不重置新鲜期和视图投影
+    if (const Entry *existing = m_entries.object(cityName); existing && existing->bundle == bundle) return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (fetchedAtMs < 0 || fetchedAtMs > now) {
+        fetchedAtMs = now;
+    }
+
+    auto *entry = new Entry;
+    entry->bundle = bundle;
+    entry->fetchedAtMs = fetchedAtMs;
+    entry->staleAt = QDeadlineTimer(qMax<qint64>(0, m_freshMs - (now - fetchedAtMs)));
+    m_entries.insert(cityName, entry, 1);
+}
+
+qint64 WeatherSnapshotStore::fetchedAt(const QString &cityName) const
+{
+    const Entry *entry = m_entries.object(cityName);
+    return entry ? entry->fetchedAtMs : -1;
+}
+
+CityWeatherBundlePtr WeatherSnapshotStore::bundle(const QString &cityName) const
+{
+    const Entry *entry = m_entries.object(cityName);
+    return entry ? entry->bundle : nullptr;
+}
+
+bool WeatherSnapshotStore::isFresh(const QString &cityName) const
+{
+    const Entry *entry = m_entries.object(cityName);
+    return entry && !entry->staleAt.hasExpired();
+}
+
+QVariantMap WeatherSnapshotStore::view(const QString &cityName, const QString &viewMode)
+{
+    // object()同时把城市移到LRU队首
+    Entry *entry = m_entries.object(cityName);
+    if (!entry) {
+        return QVariantMap();
+    }
+
+    auto it = entry->views.constFind(viewMode);
+    if (it == entry->views.cend()) {
+        it = entry->views.insert(viewMode, project(*entry->bundle, viewMode));
+    }
+    return it.value();
+}
+
+bool WeatherSnapshotStore::beginRefresh(const QString &cityName)
+{
+    if (m_refreshing.contains(cityName)) {
+        return false;
+    }
+    m_refreshing.insert(cityName, true);
+    return true;
+}
+
+void WeatherSnapshotStore::endRefresh(const QString &cityName)
+{
+    m_refreshing.remove(cityName);
+}
+
+bool WeatherSnapshotStore::needsRefresh(const QString &cityName) const
+{
+    return !cityName.isEmpty() && !m_refreshing.contains(cityName) && !isFresh(cityName);
+}
+
+void WeatherSnapshotStore::clear()
+{
+    m_entries.clear();
+}
+
+QVariantMap WeatherSnapshotStore::project(const CityWeatherBundle &bundle, const QString &viewMode)
+{
+    // 与各视图读取的字段一致：weatherData.weeklyForecast.recentDays*、detailedInfo.*、sunriseInfo.*
+    QVariantMap data;
+    if (viewMode == kTrendView) {
+        data["weeklyForecast"] = bundle.weeklyForecast().value("weeklyForecast");
+    } else if (viewMode == kDetailView) {
+        data["detailedInfo"] = bundle.current().details.toVariantMap();
+    } else if (viewMode == kSunriseView) {
+        data["sunriseInfo"] = bundle.sunriseInfo();
+    } else {
+        data = bundle.currentWeather();
+    }
+    return data;
+}
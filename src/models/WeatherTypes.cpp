@@ -0,0 +1,209 @@
+#include "../../include/commonDataType/WeatherTypes.hpp"
+#include <QVariantList>
+#include <QDataStream>
+
+namespace {
+
+// "HH:mm" -> 距零点的分钟数，格式不对时返回-1
+int minutesOfDay(const QString &text)
+{
+    const qsizetype colon = text.indexOf(u':');
+    if (colon <= 0) {
+        return -1;
+    }
+    bool hourOk = false;
+    bool minuteOk = false;
+    const int hour = QStringView(text).left(colon).toInt(&hourOk);
+    const int minute = QStringView(text).mid(colon + 1, 2).toInt(&minuteOk);
+    if (!hourOk || !minuteOk || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+        return -1;
+    }
+    return hour * 60 + minute;
+}
+
+} // namespace
+
+bool DailyForecast::temperatureFromText(QStringView text, int *value)
+{
+    // 跳过"高温"/"低温"等前缀，取第一个（可带负号的）数字串，忽略后面的单位
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        if (!text.at(i).isDigit()) {
+            continue;
+        }
+        const bool negative = i > 0 && (text.at(i - 1) == u'-' || text.at(i - 1) == u'－');
+        int result = 0;
+        for (; i < text.size() && text.at(i).isDigit(); ++i) {
+            result = result * 10 + text.at(i).digitValue();
+        }
+        *value = negative ? -result : result;
+        return true;
+    }
+    return false;
+}
+
+QVariantMap DailyForecast::toVariantMap() const
+{
+    QVariantMap map;
+    map["date"] = date;
+    map["week"] = week;
+    map["high"] = high;
+    map["low"] = low;
+    if (hasTemperature) {
+        map["highTemp"] = highTemp;
+        map["lowTemp"] = lowTemp;
+    }
+    map["type"] = type;
+    map["icon"] = icon;
+    return map;
+}
+
+QVariantMap WeatherDetails::toVariantMap() const
+{
+    QVariantMap map;
+    map["humidity"] = humidity >= 0 ? QString::number(humidity) + "%" : QStringLiteral("--");
+    map["windSpeed"] = windDirection + " " + windPower; // 风向+风力
+    map["rainfall"] = "0mm"; // API不提供当前降雨量
+    map["airQuality"] = airQuality.isEmpty() ? QStringLiteral("--") : airQuality;
+    // 接口没有气压，这一栏展示PM2.5
+    map["airPressure"] = pm25 >= 0 ? QString::number(pm25) + " μg/m³" : QStringLiteral("--");
+    map["uvIndex"] = uvIndex.isEmpty() ? QStringLiteral("--") : uvIndex;
+    return map;
+}
+
+SunTimes SunTimes::fromText(const QString &sunrise, const QString &sunset)
+{
+    SunTimes sun;
+    sun.sunrise = sunrise;
+    sun.sunset = sunset;
+    sun.sunriseMinutes = minutesOfDay(sunrise);
+    sun.sunsetMinutes = minutesOfDay(sunset);
+    return sun;
+}
+
+QVariantMap SunTimes::toVariantMap() const
+{
+    QVariantMap map;
+    map["sunrise"] = sunrise.isEmpty() ? QStringLiteral("--:--") : sunrise;
+    map["sunset"] = sunset.isEmpty() ? QStringLiteral("--:--") : sunset;
+    map["timezone"] = timezone;
+    return map;
+}
+
+QString CurrentConditions::temperatureText() const
+{
+    return qIsNaN(temperature) ? QStringLiteral("--°C") : QString::number(temperature) + "°C";
+}
+
+QString CurrentConditions::maxMinTemp() const
+{
+    return forecast.isEmpty() ? QStringLiteral("--°C / --°C") : forecast.first().maxMinText();
+}
+
+QVariantMap CurrentConditions::toVariantMap() const
+{
+    QVariantMap map;
+    map["cityName"] = cityName;
+    map["temperature"] = temperatureText();
+    map["weatherIcon"] = icon;
+    map["weatherDescription"] = type;
+    map["maxMinTemp"] = maxMinTemp();
+    map["ganmao"] = ganmao;
+    map["notice"] = notice;
+    map["detailedInfo"] = details.toVariantMap();
+    map["sunriseInfo"] = sun.toVariantMap();
+    map["weeklyForecast"] = forecastToVariantList(forecast);
+
+    // 接口原始字段名，供仍按原始字段读取的脚本回调使用
+    map["wendu"] = map["temperature"];
+    map["shidu"] = details.humidity >= 0 ? QString::number(details.humidity) + "%" : QString();
+    map["pm25"] = details.pm25 >= 0 ? QString::number(details.pm25) : QString();
+    map["quality"] = details.airQuality;
+    map["fx"] = details.windDirection;
+    map["fl"] = details.windPower;
+    map["type"] = type;
+    map["sunrise"] = sun.sunrise;
+    map["sunset"] = sun.sunset;
+    return map;
+}
+
+QVariantList forecastToVariantList(const QList<DailyForecast> &days)
+{
+    QVariantList list;
+    list.reserve(days.size());
+    for (const DailyForecast &day : days) {
+        list.append(day.toVariantMap());
+    }
+    return list;
+}
+
+QDataStream &operator<<(QDataStream &out, const DailyForecast &day)
+{
+    out << day.date << day.week << day.high << day.low
+        << qint32(day.highTemp) << qint32(day.lowTemp) << day.hasTemperature
+        << day.type << day.icon << day.windDirection << day.windPower
+        << day.sunrise << day.sunset << day.notice;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, DailyForecast &day)
+{
+    qint32 highTemp = 0;
+    qint32 lowTemp = 0;
+    in >> day.date >> day.week >> day.high >> day.low
+       >> highTemp >> lowTemp >> day.hasTemperature
+       >> day.type >> day.icon >> day.windDirection >> day.windPower
+       >> day.sunrise >> day.sunset >> day.notice;
+    day.highTemp = highTemp;
+    day.lowTemp = lowTemp;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const WeatherDetails &details)
+{
+    out << qint32(details.humidity) << details.pm25 << details.airQuality
+        << details.windDirection << details.windPower << details.uvIndex;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, WeatherDetails &details)
+{
+    qint32 humidity = -1;
+    in >> humidity >> details.pm25 >> details.airQuality
+       >> details.windDirection >> details.windPower >> details.uvIndex;
+    details.humidity = humidity;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const SunTimes &sun)
+{
+    // 分钟数由文本推出，不写入
+    out << sun.sunrise << sun.sunset << qint32(sun.timezone);
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, SunTimes &sun)
+{
+    QString sunrise;
+    QString sunset;
+    qint32 timezone = 0;
+    in >> sunrise >> sunset >> timezone;
+    sun = SunTimes::fromText(sunrise, sunset);
+    sun.timezone = timezone;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const CurrentConditions &conditions)
+{
+    out << conditions.cityName << conditions.temperature << conditions.type
+        << conditions.icon << conditions.ganmao << conditions.notice
+        << conditions.details << conditions.sun << conditions.forecast;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, CurrentConditions &conditions)
+{
+    in >> conditions.cityName >> conditions.temperature >> conditions.type
+       >> conditions.icon >> conditions.ganmao >> conditions.notice
+       >> conditions.details >> conditions.sun >> conditions.forecast;
+    return in;
+}
@@ -0,0 +1,46 @@
+#include "../../include/services/CityAliasIndex.hpp"
+#include "../../include/services/CityDirectoryData.hpp"
+
+using namespace CityDirectoryData;
+
+CityAliasIndex::CityAliasIndex()
+{
+    m_aliases.reserve(kAliasCount);
+    for (quint32 i = 0; i < kAliasCount; ++i) {
+        const Alias &alias = kAliases[i];
+        m_aliases.insert(QByteArrayView(kAliasText + alias.textOffset, alias.textLength), alias.entryIndex);
+    }
+}
+
+qsizetype CityAliasIndex::indexOf(QStringView alias) const
+{
+    const QByteArray key = normalize(alias);
+    if (key.isEmpty()) {
+        return -1;
+    }
+    const auto it = m_aliases.constFind(QByteArrayView(key));
+    return it != m_aliases.constEnd() ? qsizetype(it.value()) : -1;
+}
+
+QByteArray CityAliasIndex::normalize(QStringView alias)
+{
+    const qsizetype comma = alias.indexOf(u',');
+    if (comma >= 0) {
+        alias = alias.first(comma);
+    }
+
+    QByteArray key;
+    key.reserve(alias.size());
+    for (const QChar ch : alias) {
+        const char16_t unit = ch.unicode();
+        if (unit >= u'a' && unit <= u'z') {
+            key.append(char(unit));
+        } else if (unit >= u'A' && unit <= u'Z') {
+            key.append(char(unit - u'A' + u'a'));
+        } else if (unit >= 0x80) {
+            // 含中文等非ASCII字符的输入不是别名
+            return QByteArray();
+        }
+    }
+    return key;
+}
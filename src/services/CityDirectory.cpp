@@ -0,0 +1,98 @@
+#include "../../include/services/CityDirectory.hpp"
+#include "../../include/services/CityDirectoryData.hpp"
+
+using namespace CityDirectoryData;
+
+qsizetype CityDirectory::count() const
+{
+    return kEntryCount;
+}
+
+QStringView CityDirectory::nameAt(qsizetype index) const
+{
+    return QStringView(kNames + kEntryNameOffsets[index], kEntryNameLengths[index]);
+}
+
+quint32 CityDirectory::numericCodeAt(qsizetype index) const
+{
+    return kEntryCodes[index];
+}
+
+QString CityDirectory::codeAt(qsizetype index) const
+{
+    return QString::number(kEntryCodes[index]);
+}
+
+qsizetype CityDirectory::indexOf(QStringView cityName) const
+{
+    // 在下标上二分查找，只读取名称列
+    auto nameOf = [](quint32 index) {
+        return QStringView(kNames + kEntryNameOffsets[index], kEntryNameLengths[index]);
+    };
+    quint32 low = 0;
+    quint32 high = kEntryCount;
+    while (low < high) {
+        const quint32 mid = low + (high - low) / 2;
+        if (cityName.compare(nameOf(mid)) < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    // 同名城市取最后一条，与原先QMap逐条覆盖的行为一致
+    if (low == 0 || nameOf(low - 1) != cityName) {
+        return -1;
+    }
+    return low - 1;
+}
+
+QString CityDirectory::codeForName(QStringView cityName) const
+{
+    const qsizetype index = indexOf(cityName);
+    return index >= 0 ? codeAt(index) : QString();
+}
+
+qsizetype CityDirectory::tableFootprint()
+{
+    const PinyinKey &lastKey = kPinyinKeys[kPinyinKeyCount > 0 ? kPinyinKeyCount - 1 : 0];
+    const qsizetype pinyinTextLength = kPinyinKeyCount > 0 ? lastKey.textOffset + lastKey.textLength : 0;
+    // 别名文本按别名表的顺序首尾相连，最后一条的结尾就是总长度
+    const Alias &lastAlias = kAliases[kAliasCount > 0 ? kAliasCount - 1 : 0];
+    const qsizetype aliasTextLength = kAliasCount > 0 ? lastAlias.textOffset + lastAlias.textLength : 0;
+
+    qsizetype childCount = 0;
+    for (quint32 i = 0; i < kNodeCount; ++i) {
+        childCount += kNodeChildCounts[i];
+    }
+
+    // 城市表：名称偏移和代码各4字节，名称长度和节点下标各2字节
+    const qsizetype entryBytes = 2 * sizeof(quint32) + 2 * sizeof(quint16);
+    // 层级表：名称偏移和代码各4字节，其余五列各2字节
+    const qsizetype nodeBytes = 2 * sizeof(quint32) + 5 * sizeof(quint16);
+
+    return kEntryCount * entryBytes
+           + kNamesLength * qsizetype(sizeof(char16_t))
+           + kNodeCount * nodeBytes
+           + childCount * qsizetype(sizeof(quint16))
+           + kPinyinKeyCount * qsizetype(sizeof(PinyinKey))
+           + pinyinTextLength
+           + kAliasCount * qsizetype(sizeof(Alias))
+           + aliasTextLength;
+}
+
+qsizetype CityDirectory::legacyMapFootprint()
+{
+    // 按64位平台估算：每条记录一个红黑树节点（指针 + 颜色 + 两个QString句柄），
+    // 加上名称和代码各一块QArrayData（16字节头 + UTF-16内容 + 结尾0），都按16字节对齐分配
+    auto heapBlock = [](qsizetype bytes) { return (bytes + 15) / 16 * 16; };
+    constexpr qsizetype kCodeLength = 9;
+
+    qsizetype total = 0;
+    for (quint32 i = 0; i < kEntryCount; ++i) {
+        total += heapBlock(32 + 2 * 24);
+        total += heapBlock(16 + (kEntryNameLengths[i] + 1) * 2);
+        total += heapBlock(16 + (kCodeLength + 1) * 2);
+    }
+    return total;
+}
@@ -0,0 +1,141 @@
+#include "../../include/services/CityFuzzyMatcher.hpp"
+#include <QString>
+#include <QVarLengthArray>
+#include <algorithm>
+
+namespace {
+
+// 查询中每个不同字符出现位置的位图（Peq表）
+// 查询通常只有几个字，线性查找比哈希表更快
+class PatternMasks
+{
+public:
+    explicit PatternMasks(QStringView pattern)
+    {
+        for (qsizetype i = 0; i < pattern.size(); ++i) {
+            const char16_t unit = pattern.at(i).toCaseFolded().unicode();
+            auto it = std::find_if(m_masks.begin(), m_masks.end(), [unit](const Mask &mask) {
+                return mask.unit == unit;
+            });
+            if (it == m_masks.end()) {
+                m_masks.append({unit, 0});
+                it = m_masks.end() - 1;
+            }
+            it->bits |= quint64(1) << i;
+        }
+    }
+
+    quint64 bitsFor(char16_t unit) const
+    {
+        for (const Mask &mask : m_masks) {
+            if (mask.unit == unit) {
+                return mask.bits;
+            }
+        }
+        return 0;
+    }
+
+private:
+    struct Mask {
+        char16_t unit;
+        quint64 bits;
+    };
+    QVarLengthArray<Mask, 16> m_masks;
+};
+
+// Hyyrö对Myers算法的整串编辑距离版本：逐个文本字符更新一列差分向量
+// limit >= 0 时，一旦剩余字符不足以把距离降到limit以内就提前返回limit + 1
+int bitParallelDistance(const PatternMasks &masks, qsizetype patternLength, QStringView text, int limit)
+{
+    const quint64 highBit = quint64(1) << (patternLength - 1);
+    quint64 pv = ~quint64(0);
+    quint64 mv = 0;
+    int score = int(patternLength);
+
+    for (qsizetype j = 0; j < text.size(); ++j) {
+        const quint64 eq = masks.bitsFor(text.at(j).toCaseFolded().unicode());
+        const quint64 xv = eq | mv;
+        const quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        quint64 ph = mv | ~(xh | pv);
+        quint64 mh = pv & xh;
+        if (ph & highBit) {
+            ++score;
+        } else if (mh & highBit) {
+            --score;
+        }
+        // 第0行是D[0][j] = j，横向差分恒为+1，所以移入1
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // 每个剩余字符最多让距离减1
+        if (limit >= 0 && score - (text.size() - 1 - j) > limit) {
+            return limit + 1;
+        }
+    }
+    return score;
+}
+
+}
+
+CityFuzzyMatcher::CityFuzzyMatcher(const CityDirectory &directory)
+    : m_directory(directory)
+{
+}
+
+QList<CityFuzzyMatcher::Match> CityFuzzyMatcher::findApproximate(QStringView query, int maxDistance, qsizetype limit,
+                                                                 qsizetype *total) const
+{
+    QList<Match> matches;
+    if (total) {
+        *total = 0;
+    }
+    const qsizetype length = query.size();
+    if (length == 0 || length > kMaxQueryLength) {
+        return matches;
+    }
+    if (maxDistance < 0) {
+        maxDistance = qMax(1, int(length / 3));
+    }
+
+    const PatternMasks masks(query);
+    for (qsizetype i = 0; i < m_directory.count(); ++i) {
+        const QStringView name = m_directory.nameAt(i);
+        // 长度差本身就是编辑距离的下界
+        if (qAbs(name.size() - length) > maxDistance) {
+            continue;
+        }
+        const int distance = bitParallelDistance(masks, length, name, maxDistance);
+        if (distance <= maxDistance) {
+            matches.append({i, distance});
+        }
+    }
+
+    if (total) {
+        *total = matches.size();
+    }
+
+    auto rankBefore = [this](const Match &a, const Match &b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        const qsizetype lengthA = m_directory.nameAt(a.index).size();
+        const qsizetype lengthB = m_directory.nameAt(b.index).size();
+        if (lengthA != lengthB) return lengthA < lengthB;
+        return a.index < b.index;
+    };
+    const qsizetype count = qBound<qsizetype>(0, limit, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), rankBefore);
+    matches.resize(count);
+    return matches;
+}
+
+int CityFuzzyMatcher::distance(QStringView query, QStringView text)
+{
+    if (query.isEmpty()) {
+        return int(text.size());
+    }
+    if (query.size() > kMaxQueryLength) {
+        return -1;
+    }
+    return bitParallelDistance(PatternMasks(query), query.size(), text, -1);
+}
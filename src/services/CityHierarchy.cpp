@@ -0,0 +1,199 @@
+#include "../../include/services/CityHierarchy.hpp"
+#include "../../include/services/CityDirectoryData.hpp"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+using namespace CityDirectoryData;
+
+CityHierarchy::CityHierarchy()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_byCode.reserve(kEntryCount);
+    m_byName.reserve(kNodeCount);
+    m_nextSameName.fill(kNoIndex, kNodeCount);
+    m_nextSameBase.fill(kNoIndex, kNodeCount);
+    // 倒序插入，使每条同名链表按文件顺序排列
+    for (quint32 node = kNodeCount; node-- > 0;) {
+        const QStringView name = nameAt(node);
+        if (kNodeCodes[node] != 0) {
+            m_byCode.insert(kNodeCodes[node], node);
+        }
+        m_nextSameName[node] = m_byName.value(name, kNoIndex);
+        m_byName.insert(name, node);
+        const QStringView base = baseName(name);
+        if (base.size() != name.size()) {
+            m_nextSameBase[node] = m_byBaseName.value(base, kNoIndex);
+            m_byBaseName.insert(base, node);
+        }
+    }
+
+    qDebug() << "CityHierarchy built:" << kNodeCount << "nodes," << m_byName.size() << "names,"
+             << memoryFootprint() << "bytes in" << timer.nsecsElapsed() / 1000 << "us";
+}
+
+qsizetype CityHierarchy::nodeCount() const
+{
+    return kNodeCount;
+}
+
+QStringView CityHierarchy::nameAt(quint32 node) const
+{
+    return QStringView(kNames + kNodeNameOffsets[node], kNodeNameLengths[node]);
+}
+
+quint32 CityHierarchy::codeAt(quint32 node) const
+{
+    return kNodeCodes[node];
+}
+
+quint32 CityHierarchy::parentOf(quint32 node) const
+{
+    return widenIndex(kNodeParents[node]);
+}
+
+QList<quint32> CityHierarchy::childrenOf(quint32 node) const
+{
+    const quint16 *begin = kChildren + kNodeChildOffsets[node];
+    return QList<quint32>(begin, begin + kNodeChildCounts[node]);
+}
+
+QList<quint32> CityHierarchy::ancestorsOf(quint32 node) const
+{
+    QList<quint32> ancestors;
+    // 限制深度，防止数据中出现环
+    for (quint32 parent = parentOf(node); parent != kNoIndex && ancestors.size() < 8; parent = parentOf(parent)) {
+        ancestors.append(parent);
+    }
+    return ancestors;
+}
+
+qsizetype CityHierarchy::directoryIndexOf(quint32 node) const
+{
+    const quint32 entry = widenIndex(kNodeEntries[node]);
+    return entry == kNoIndex ? -1 : qsizetype(entry);
+}
+
+quint32 CityHierarchy::nodeOfDirectoryIndex(qsizetype index) const
+{
+    return kEntryNodes[index];
+}
+
+quint32 CityHierarchy::nodeForCode(quint32 cityCode) const
+{
+    return m_byCode.value(cityCode, kNoIndex);
+}
+
+QList<quint32> CityHierarchy::nodesNamed(QStringView name) const
+{
+    auto exact = m_byName.constFind(name);
+    if (exact != m_byName.constEnd()) {
+        return collectChain(exact.value(), m_nextSameName);
+    }
+    auto base = m_byBaseName.constFind(name);
+    if (base != m_byBaseName.constEnd()) {
+        return collectChain(base.value(), m_nextSameBase);
+    }
+    // 输入多带了后缀（北京市 -> 北京）
+    const QStringView stripped = baseName(name);
+    if (stripped.size() != name.size()) {
+        return collectChain(m_byName.value(stripped, kNoIndex), m_nextSameName);
+    }
+    return QList<quint32>();
+}
+
+quint32 CityHierarchy::resolve(QStringView query) const
+{
+    query = query.trimmed();
+
+    // 拆分"名称 (上级地名)"，兼容全角括号
+    QStringView name = query;
+    QStringView qualifier;
+    if (query.endsWith(u')') || query.endsWith(u'）')) {
+        const qsizetype open = qMax(query.lastIndexOf(u'('), query.lastIndexOf(u'（'));
+        if (open > 0) {
+            name = query.first(open).trimmed();
+            qualifier = query.sliced(open + 1, query.size() - open - 2).trimmed();
+        }
+    }
+
+    // 在候选中选有代码、符合上级地名且层级最高的节点
+    auto pick = [&](const QList<quint32> &candidates) {
+        quint32 best = kNoIndex;
+        int bestDepth = 0;
+        for (quint32 node : candidates) {
+            if (codeAt(node) == 0 || (!qualifier.isEmpty() && !hasAncestorNamed(node, qualifier))) {
+                continue;
+            }
+            const int depth = depthOf(node);
+            if (best == kNoIndex || depth < bestDepth) {
+                best = node;
+                bestDepth = depth;
+            }
+        }
+        return best;
+    };
+
+    const quint32 best = pick(nodesNamed(name));
+    if (best != kNoIndex || !m_byName.contains(name)) {
+        return best;
+    }
+    // 同名地点都不符合时，再看带后缀的地点："九龙 (甘孜)"中的"九龙"同时是香港的九龙和甘孜的九龙县
+    return pick(collectChain(m_byBaseName.value(name, kNoIndex), m_nextSameBase));
+}
+
+QString CityHierarchy::qualifiedName(quint32 node) const
+{
+    const quint32 parent = parentOf(node);
+    if (parent == kNoIndex) {
+        return nameAt(node).toString();
+    }
+    return nameAt(node).toString() + QStringLiteral(" (") + nameAt(parent).toString() + QStringLiteral(")");
+}
+
+QStringView CityHierarchy::baseName(QStringView name)
+{
+    static const char16_t suffixes[] = { u'市', u'区', u'县', u'盟' };
+    if (name.size() > 2 && std::find(std::begin(suffixes), std::end(suffixes), name.back().unicode()) != std::end(suffixes)) {
+        return name.chopped(1);
+    }
+    return name;
+}
+
+qsizetype CityHierarchy::memoryFootprint() const
+{
+    // QHash的每个桶约为键 + 值 + 1字节偏移
+    const qsizetype codeBytes = m_byCode.capacity() * qsizetype(2 * sizeof(quint32) + 1);
+    const qsizetype nameBytes = (m_byName.capacity() + m_byBaseName.capacity())
+                                * qsizetype(sizeof(QStringView) + sizeof(quint32) + 1);
+    const qsizetype chainBytes = (m_nextSameName.capacity() + m_nextSameBase.capacity()) * qsizetype(sizeof(quint32));
+    return sizeof(*this) + codeBytes + nameBytes + chainBytes;
+}
+
+QList<quint32> CityHierarchy::collectChain(quint32 head, const QList<quint32> &next) const
+{
+    QList<quint32> nodes;
+    for (quint32 node = head; node != kNoIndex; node = next.at(node)) {
+        nodes.append(node);
+    }
+    return nodes;
+}
+
+bool CityHierarchy::hasAncestorNamed(quint32 node, QStringView qualifier) const
+{
+    const QStringView qualifierBase = baseName(qualifier);
+    for (quint32 ancestor : ancestorsOf(node)) {
+        const QStringView ancestorName = nameAt(ancestor);
+        if (ancestorName == qualifier || baseName(ancestorName) == qualifierBase) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int CityHierarchy::depthOf(quint32 node) const
+{
+    return int(ancestorsOf(node).size());
+}
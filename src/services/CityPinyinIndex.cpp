@@ -0,0 +1,119 @@
+#include "../../include/services/CityPinyinIndex.hpp"
+#include "../../include/services/CityDirectoryData.hpp"
+#include <QByteArray>
+#include <algorithm>
+#include <string_view>
+
+using namespace CityDirectoryData;
+
+namespace {
+
+std::string_view keyText(const PinyinKey &key)
+{
+    return std::string_view(kPinyinText + key.textOffset, key.textLength);
+}
+
+// 一个候选城市及其排序依据，数值越小越靠前
+struct Candidate {
+    quint32 entryIndex;
+    int exactness;      // 0: 键与查询完全相同，1: 查询只是前缀
+    int kind;           // 全拼优先于首字母
+    int remaining;      // 键比查询多出的字母数
+    int nameLength;     // 名称越短（通常是上级城市）越靠前
+};
+
+bool rankBefore(const Candidate &a, const Candidate &b)
+{
+    if (a.exactness != b.exactness) return a.exactness < b.exactness;
+    if (a.remaining != b.remaining) return a.remaining < b.remaining;
+    if (a.kind != b.kind) return a.kind < b.kind;
+    if (a.nameLength != b.nameLength) return a.nameLength < b.nameLength;
+    return a.entryIndex < b.entryIndex;
+}
+
+}
+
+bool CityPinyinIndex::isPinyinQuery(QStringView query)
+{
+    return !normalize(query).isEmpty();
+}
+
+QList<qsizetype> CityPinyinIndex::findPrefix(QStringView query, qsizetype limit, qsizetype *total) const
+{
+    QList<qsizetype> result;
+    if (total) {
+        *total = 0;
+    }
+    const QByteArray prefix = normalize(query);
+    if (prefix.isEmpty()) {
+        return result;
+    }
+
+    // 前缀区间：[第一个 >= prefix 的键, 第一个不以prefix开头的键)
+    const std::string_view value(prefix.constData(), size_t(prefix.size()));
+    const PinyinKey *begin = kPinyinKeys;
+    const PinyinKey *end = kPinyinKeys + kPinyinKeyCount;
+    const PinyinKey *first = std::lower_bound(begin, end, value, [](const PinyinKey &key, std::string_view text) {
+        return keyText(key) < text;
+    });
+    const PinyinKey *last = std::upper_bound(first, end, value, [](std::string_view text, const PinyinKey &key) {
+        return text < keyText(key).substr(0, text.size());
+    });
+
+    // 同一城市可能同时命中全拼和首字母，只保留排名最高的一条
+    QList<Candidate> candidates;
+    candidates.reserve(last - first);
+    for (const PinyinKey *key = first; key != last; ++key) {
+        const Candidate candidate{
+            key->entryIndex,
+            key->textLength == prefix.size() ? 0 : 1,
+            key->kind,
+            int(key->textLength) - int(prefix.size()),
+            int(kEntryNameLengths[key->entryIndex])
+        };
+        candidates.append(candidate);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        if (a.entryIndex != b.entryIndex) return a.entryIndex < b.entryIndex;
+        return rankBefore(a, b);
+    });
+    candidates.erase(std::unique(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.entryIndex == b.entryIndex;
+    }), candidates.end());
+    if (total) {
+        *total = candidates.size();
+    }
+
+    const qsizetype count = qBound<qsizetype>(0, limit, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), rankBefore);
+
+    result.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        result.append(candidates.at(i).entryIndex);
+    }
+    return result;
+}
+
+qsizetype CityPinyinIndex::keyCount() const
+{
+    return kPinyinKeyCount;
+}
+
+QByteArray CityPinyinIndex::normalize(QStringView query)
+{
+    QByteArray normalized;
+    normalized.reserve(query.size());
+    for (const QChar ch : query) {
+        const char16_t unit = ch.unicode();
+        if (unit >= u'a' && unit <= u'z') {
+            normalized.append(char(unit));
+        } else if (unit >= u'A' && unit <= u'Z') {
+            normalized.append(char(unit - u'A' + u'a'));
+        } else if (unit == u' ' || unit == u'\'' || unit == u'-') {
+            continue;
+        } else {
+            return QByteArray();
+        }
+    }
+    return normalized;
+}
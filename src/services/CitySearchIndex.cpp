@@ -0,0 +1,125 @@
+#include "../../include/services/CitySearchIndex.hpp"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+CitySearchIndex::CitySearchIndex(const CityDirectory &directory)
+    : m_directory(directory)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 先收集(键, 城市下标)对，排序去重后压缩成键表 + 偏移表 + 倒排数组
+    QList<std::pair<quint32, quint32>> pairs;
+    for (qsizetype i = 0; i < m_directory.count(); ++i) {
+        const QString name = foldCase(m_directory.nameAt(i));
+        const quint32 index = quint32(i);
+        for (qsizetype c = 0; c < name.size(); ++c) {
+            pairs.append({unigramKey(name.at(c)), index});
+            if (c + 1 < name.size()) {
+                pairs.append({bigramKey(name.at(c), name.at(c + 1)), index});
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    // 同一名称内重复出现的字只记录一次
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    m_postings.reserve(pairs.size());
+    for (const auto &[key, index] : std::as_const(pairs)) {
+        if (m_keys.isEmpty() || m_keys.constLast() != key) {
+            m_keys.append(key);
+            m_offsets.append(quint32(m_postings.size()));
+        }
+        m_postings.append(index);
+    }
+    m_offsets.append(quint32(m_postings.size()));
+    m_keys.squeeze();
+    m_offsets.squeeze();
+
+    qDebug() << "CitySearchIndex built:" << m_keys.size() << "keys," << m_postings.size() << "postings,"
+             << memoryFootprint() << "bytes in" << timer.nsecsElapsed() / 1000 << "us";
+}
+
+QList<qsizetype> CitySearchIndex::findSubstring(QStringView query) const
+{
+    QList<qsizetype> result;
+    const QString folded = foldCase(query);
+    if (folded.isEmpty()) {
+        return result;
+    }
+
+    // 单字查询直接返回该字的倒排表
+    if (folded.size() == 1) {
+        const PostingRange postings = postingsFor(unigramKey(folded.at(0)));
+        result.reserve(postings.size());
+        for (const quint32 *it = postings.begin; it != postings.end; ++it) {
+            result.append(*it);
+        }
+        return result;
+    }
+
+    // 收集所有bigram的倒排表，从最短的开始求交集
+    QList<PostingRange> lists;
+    for (qsizetype c = 0; c + 1 < folded.size(); ++c) {
+        const PostingRange postings = postingsFor(bigramKey(folded.at(c), folded.at(c + 1)));
+        if (postings.size() == 0) {
+            return result;
+        }
+        lists.append(postings);
+    }
+    std::sort(lists.begin(), lists.end(), [](const PostingRange &a, const PostingRange &b) {
+        return a.size() < b.size();
+    });
+
+    QList<quint32> candidates(lists.constFirst().begin, lists.constFirst().end);
+    for (qsizetype i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        QList<quint32> narrowed;
+        std::set_intersection(candidates.cbegin(), candidates.cend(),
+                              lists.at(i).begin, lists.at(i).end,
+                              std::back_inserter(narrowed));
+        candidates = std::move(narrowed);
+    }
+
+    // bigram全部出现不代表连续出现，候选再做一次子串校验
+    for (quint32 index : std::as_const(candidates)) {
+        if (foldCase(m_directory.nameAt(index)).contains(folded)) {
+            result.append(index);
+        }
+    }
+    return result;
+}
+
+qsizetype CitySearchIndex::memoryFootprint() const
+{
+    return sizeof(*this)
+           + (m_keys.capacity() + m_offsets.capacity() + m_postings.capacity()) * qsizetype(sizeof(quint32));
+}
+
+CitySearchIndex::PostingRange CitySearchIndex::postingsFor(quint32 key) const
+{
+    const auto it = std::lower_bound(m_keys.cbegin(), m_keys.cend(), key);
+    if (it == m_keys.cend() || *it != key) {
+        return PostingRange();
+    }
+    const qsizetype slot = it - m_keys.cbegin();
+    const quint32 *base = m_postings.constData();
+    return PostingRange{base + m_offsets.at(slot), base + m_offsets.at(slot + 1)};
+}
+
+quint32 CitySearchIndex::unigramKey(QChar ch)
+{
+    return ch.unicode();
+}
+
+quint32 CitySearchIndex::bigramKey(QChar first, QChar second)
+{
+    return (quint32(first.unicode()) << 16) | second.unicode();
+}
+
+QString CitySearchIndex::foldCase(QStringView text)
+{
+    return text.toString().toCaseFolded();
+}
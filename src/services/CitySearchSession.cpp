@@ -0,0 +1,153 @@
+#include "../../include/services/CitySearchSession.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// 查询链最多保留的步数，超出时丢弃最早（最宽泛）的一步
+constexpr qsizetype kMaxSteps = 16;
+
+}
+
+CitySearchSession::CitySearchSession(const CityDirectory &directory, const CitySearchIndex &searchIndex,
+                                     const CityPinyinIndex &pinyinIndex, const CityFuzzyMatcher &fuzzyMatcher,
+                                     const CityAliasIndex &aliasIndex)
+    : m_directory(directory)
+    , m_searchIndex(searchIndex)
+    , m_pinyinIndex(pinyinIndex)
+    , m_fuzzyMatcher(fuzzyMatcher)
+    , m_aliasIndex(aliasIndex)
+{
+}
+
+CitySearchSession::Page CitySearchSession::search(QStringView query, qsizetype offset, qsizetype limit)
+{
+    offset = qMax<qsizetype>(0, offset);
+    limit = qMax<qsizetype>(0, limit);
+
+    // 别名精确命中（Peking、Xi'an、Hong Kong、"Beijing,CN"）排在最前，拼音和中文查询都先查别名表
+    const qsizetype aliasHit = m_aliasIndex.indexOf(query);
+
+    // 拼音查询本身只需两次二分查找，直接取前offset + limit条
+    if (CityPinyinIndex::isPinyinQuery(query)) {
+        if (aliasHit >= 0) {
+            // 需要全部前缀匹配才能正确去重计数
+            return aliasFirstPage(aliasHit, m_pinyinIndex.findPrefix(query, std::numeric_limits<qsizetype>::max()),
+                                  offset, limit);
+        }
+        Page page;
+        page.offset = offset;
+        page.indices = m_pinyinIndex.findPrefix(query, offset + limit, &page.total).mid(offset);
+        return page;
+    }
+
+    const QString folded = query.toString().toCaseFolded();
+    if (folded.isEmpty()) {
+        Page page;
+        page.offset = offset;
+        return page;
+    }
+    const QList<qsizetype> &candidates = candidatesFor(folded);
+    if (aliasHit >= 0) {
+        return aliasFirstPage(aliasHit, rankPage(folded, candidates, 0, candidates.size()).indices, offset, limit);
+    }
+    if (candidates.isEmpty()) {
+        // 没有名称包含查询（如"石家装"），按编辑距离找最接近的城市
+        return approximatePage(folded, offset, limit);
+    }
+    return rankPage(folded, candidates, offset, limit);
+}
+
+void CitySearchSession::reset()
+{
+    m_steps.clear();
+}
+
+const QList<qsizetype> &CitySearchSession::candidatesFor(const QString &query)
+{
+    // 退格或改写：丢弃不再是当前查询前缀的步骤
+    while (!m_steps.isEmpty() && !query.startsWith(m_steps.constLast().query)) {
+        m_steps.removeLast();
+    }
+    if (!m_steps.isEmpty() && m_steps.constLast().query == query) {
+        return m_steps.constLast().candidates;
+    }
+
+    Step step;
+    step.query = query;
+    if (m_steps.isEmpty()) {
+        step.candidates = m_searchIndex.findSubstring(query);
+        ++m_fullSearchCount;
+    } else {
+        // 包含新查询的名称必然包含旧查询，只需在旧候选里过滤
+        const QList<qsizetype> &previous = m_steps.constLast().candidates;
+        for (qsizetype index : previous) {
+            if (m_directory.nameAt(index).contains(query, Qt::CaseInsensitive)) {
+                step.candidates.append(index);
+            }
+        }
+        ++m_narrowedCount;
+    }
+
+    if (m_steps.size() >= kMaxSteps) {
+        m_steps.removeFirst();
+    }
+    m_steps.append(std::move(step));
+    return m_steps.constLast().candidates;
+}
+
+CitySearchSession::Page CitySearchSession::rankPage(const QString &query, const QList<qsizetype> &candidates,
+                                                    qsizetype offset, qsizetype limit) const
+{
+    Page page;
+    page.offset = offset;
+    page.total = candidates.size();
+    if (offset >= candidates.size() || limit == 0) {
+        return page;
+    }
+
+    // 排序依据：以查询开头的名称优先，其次名称较短的，最后按目录顺序
+    auto rankBefore = [&](qsizetype a, qsizetype b) {
+        const QStringView nameA = m_directory.nameAt(a);
+        const QStringView nameB = m_directory.nameAt(b);
+        const bool prefixA = nameA.startsWith(query, Qt::CaseInsensitive);
+        const bool prefixB = nameB.startsWith(query, Qt::CaseInsensitive);
+        if (prefixA != prefixB) return prefixA;
+        if (nameA.size() != nameB.size()) return nameA.size() < nameB.size();
+        return a < b;
+    };
+
+    // 只对需要的前offset + limit条做部分排序
+    QList<qsizetype> ranked = candidates;
+    const qsizetype end = qMin(offset + limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + end, ranked.end(), rankBefore);
+    page.indices = ranked.mid(offset, end - offset);
+    return page;
+}
+
+CitySearchSession::Page CitySearchSession::aliasFirstPage(qsizetype aliasHit, QList<qsizetype> ranked,
+                                                          qsizetype offset, qsizetype limit)
+{
+    ranked.removeOne(aliasHit);
+    ranked.prepend(aliasHit);
+
+    Page page;
+    page.offset = offset;
+    page.total = ranked.size();
+    page.indices = ranked.mid(offset, limit);
+    return page;
+}
+
+CitySearchSession::Page CitySearchSession::approximatePage(const QString &query, qsizetype offset, qsizetype limit) const
+{
+    Page page;
+    page.offset = offset;
+    page.approximate = true;
+
+    const QList<CityFuzzyMatcher::Match> matches = m_fuzzyMatcher.findApproximate(query, -1, offset + limit, &page.total);
+    for (qsizetype i = offset; i < matches.size(); ++i) {
+        page.indices.append(matches.at(i).index);
+        page.distances.append(matches.at(i).distance);
+    }
+    return page;
+}
@@ -1,4 +1,5 @@
 #include "../../include/services/WeatherAPIClient.hpp"
+#include "../../include/services/CityDirectoryData.hpp"
 #include <QNetworkRequest>
 #include <QUrl>
 #include <QUrlQuery>
@@ -15,11 +16,16 @@
 #include <QNetworkReply>
 #include <QHash>
 #include <QRegularExpression>
-#include <QFile>
 #include <QMap>
-#include <QIODevice>
+#include <QThread>
+#include <QPointer>
+#include <QCoreApplication>
+#include <QFuture>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
 #include <algorithm>
 #include <functional>
+#include <utility>
 
 WeatherAPIClient::WeatherAPIClient(QObject *parent)
     : QObject(parent)
@@ -27,23 +33,69 @@ WeatherAPIClient::WeatherAPIClient(QObject *parent)
     , m_apiKey("") // 新的API不需要apiKey，所以这里留空
     , m_baseUrl("http://t.weather.itboy.net/api/weather/city/") // 修改为新的API地址
 {
-    // 连接网络请求完成信号
-    connect(m_networkManager, &QNetworkAccessManager::finished,
-            this, &WeatherAPIClient::onNetworkReplyFinished);
+    // 响应解析线程池，不与全局线程池争用
+    m_parsePool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
     
-    // 在构造函数中加载城市代码
-    loadCityCodes();
+    // 城市表在构建期编译进程序；其上的索引在后台构建，不阻塞首帧
+    loadDirectoryAsync();
 }
 
 WeatherAPIClient::~WeatherAPIClient()
 {
-    // 清理未完成的请求
-    for (auto it = m_callbacks.begin(); it != m_callbacks.end(); ++it) {
-        it.key()->deleteLater();
+    // 未完成的reply是m_networkManager的子对象，会随之销毁；这里只丢弃等待者
+    m_inFlightWeather.clear();
+    m_inFlightSearch.clear();
+}
+
+void WeatherAPIClient::loadDirectoryAsync()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QtConcurrent::run(&m_parsePool, []() {
+        return std::shared_ptr<const CityIndexes>(std::make_shared<CityIndexes>());
+    }).then(this, [this, timer](const std::shared_ptr<const CityIndexes> &indexes) {
+        const qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+        m_indexes = indexes;
+        m_searchSession = std::make_unique<CitySearchSession>(
+            m_indexes->directory, m_indexes->searchIndex, m_indexes->pinyinIndex, m_indexes->fuzzyMatcher,
+            m_indexes->aliasIndex);
+        qDebug() << "City directory ready in" << elapsedUs << "us," << directoryStats();
+
+        // 先取出队列，避免执行中再有排队导致迭代失效
+        const QList<std::function<void()>> pending = std::exchange(m_pendingLookups, {});
+        emit directoryReady();
+        for (const std::function<void()> &task : pending) {
+            task();
+        }
+    });
+}
+
+void WeatherAPIClient::whenDirectoryReady(std::function<void()> task)
+{
+    if (isDirectoryReady()) {
+        task();
+    } else {
+        m_pendingLookups.append(std::move(task));
+    }
+}
+
+bool WeatherAPIClient::deferUntilDirectoryReady(std::function<void()> task)
+{
+    if (isDirectoryReady()) {
+        return false;
     }
-    for (auto it = m_listCallbacks.begin(); it != m_listCallbacks.end(); ++it) {
-        it.key()->deleteLater();
+    m_pendingLookups.append(std::move(task));
+    return true;
+}
+
+WeatherAPIClient *WeatherAPIClient::shared()
+{
+    static QPointer<WeatherAPIClient> instance;
+    if (!instance) {
+        instance = new WeatherAPIClient(QCoreApplication::instance());
     }
+    return instance;
 }
 
 void WeatherAPIClient::setApiKey(const QString &apiKey)
@@ -53,414 +105,363 @@ void WeatherAPIClient::setApiKey(const QString &apiKey)
 
 void WeatherAPIClient::setBaseUrl(const QString &baseUrl)
 {
-    m_baseUrl = baseUrl;
+    if (m_baseUrl != baseUrl) {
+        m_baseUrl = baseUrl;
+        // 数据源变化后旧缓存不再可信
+        m_cache.clear();
+    }
 }
 
-void WeatherAPIClient::getCurrentWeather(const QString &cityName, std::function<void(const QVariantMap&)> callback)
+void WeatherAPIClient::setCacheTtl(int ttlMs)
 {
-    if (!m_cityCodeMap.contains(cityName)) {
-        callback(createErrorResponse("City not found", cityName));
+    m_cache.setDefaultTtl(ttlMs);
+}
+
+void WeatherAPIClient::setCacheMemoryBudget(qint64 maxBytes)
+{
+    m_cache.setMaxBytes(maxBytes);
+}
+
+void WeatherAPIClient::clearCache()
+{
+    m_cache.clear();
+}
+
+QVariantMap WeatherAPIClient::cacheStats() const
+{
+    return m_cache.stats();
+}
+
+WeatherRequestId WeatherAPIClient::getWeatherBundle(const QString &cityName, BundleCallback callback)
+{
+    const WeatherRequestId requestId = ++m_nextRequestId;
+    m_liveRequests.insert(requestId, {});
+    startWeatherBundle(requestId, cityName, std::move(callback));
+    // 同步完成的请求已从列表移除，没有可取消的内容
+    return m_liveRequests.contains(requestId) ? requestId : 0;
+}
+
+void WeatherAPIClient::startWeatherBundle(WeatherRequestId requestId, const QString &cityName, BundleCallback callback)
+{
+    if (deferUntilDirectoryReady([this, requestId, cityName, callback]() {
+            // 等待城市目录期间已被取消
+            if (m_liveRequests.contains(requestId)) {
+                startWeatherBundle(requestId, cityName, callback);
+            }
+        })) {
         return;
     }
-    QString cityCode = m_cityCodeMap.value(cityName);
-    QString url = buildCurrentWeatherUrl(cityCode);
-    sendRequest(url, callback);
+    QString cityCode = codeForCity(cityName);
+    if (cityCode.isEmpty()) {
+        m_liveRequests.remove(requestId);
+        callback(nullptr, "City not found");
+        return;
+    }
+    fetchCityWeather(cityCode, requestId, std::move(callback));
 }
 
-void WeatherAPIClient::getWeeklyForecast(const QString &cityName, std::function<void(const QVariantMap&)> callback)
+void WeatherAPIClient::cancel(WeatherRequestId requestId)
 {
-    if (!m_cityCodeMap.contains(cityName)) {
-        callback(createErrorResponse("City not found", cityName));
+    auto it = m_liveRequests.find(requestId);
+    if (it == m_liveRequests.end()) {
         return;
     }
-    QString cityCode = m_cityCodeMap.value(cityName);
-    QString url = buildCurrentWeatherUrl(cityCode);
-    
-    qDebug() << "Getting weekly forecast for city:" << cityName << "with code:" << cityCode;
-    qDebug() << "Weekly forecast URL:" << url;
-    
-    // 创建专门的回调函数来解析周预报数据
-    auto weeklyCallback = [this, callback, cityName](const QVariantMap& rawData) {
-        qDebug() << "Weekly forecast raw data received for" << cityName << ":" << rawData;
-        
-        if (rawData.contains("error")) {
-            qDebug() << "Error in weekly forecast data:" << rawData["error"];
-            callback(rawData);
-            return;
-        }
-        
-        // 从原始数据中提取JSON并使用parseWeeklyForecastData解析
-        QJsonObject json = QJsonObject::fromVariantMap(rawData);
-        QVariantMap result = parseWeeklyForecastData(json);
-        qDebug() << "Parsed weekly forecast result:" << result;
-        callback(result);
-    };
-    
-    sendRequest(url, weeklyCallback);
+    const std::shared_ptr<WeatherRequest<CityWeatherBundlePtr>> pending = it.value().lock();
+    m_liveRequests.erase(it);
+    ++m_requestStats.cancelled;
+
+    // 还在等待城市目录时pending为空，移出列表即可
+    if (pending && pending->cancelWaiter(requestId) && pending->isCompleted()) {
+        qDebug() << "Aborted request with no remaining waiters:" << pending->url().toString();
+    }
+}
+
+void WeatherAPIClient::getCurrentWeather(const QString &cityName, std::function<void(const QVariantMap&)> callback)
+{
+    getWeatherBundle(cityName, [this, callback, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
+        callback(bundle ? bundle->currentWeather() : createErrorResponse(error, cityName));
+    });
+}
+
+void WeatherAPIClient::getWeeklyForecast(const QString &cityName, std::function<void(const QVariantMap&)> callback)
+{
+    // 直接使用数据包中已解析好的预报投影
+    getWeatherBundle(cityName, [this, callback, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
+        callback(bundle ? bundle->weeklyForecast() : createErrorResponse(error, cityName));
+    });
 }
 
 void WeatherAPIClient::getDailyForecast(const QString &cityName, std::function<void(const QVariantMap&)> callback)
 {
-    if (!m_cityCodeMap.contains(cityName)) {
-        callback(createErrorResponse("City not found", cityName));
-        return;
-    }
-    QString cityCode = m_cityCodeMap.value(cityName);
-    QString url = buildCurrentWeatherUrl(cityCode);
-    
-    // 创建专门的回调函数来解析日预报数据
-    auto dailyCallback = [this, callback](const QVariantMap& rawData) {
-        if (rawData.contains("error")) {
-            callback(rawData);
-            return;
-        }
-        
-        // 从原始数据中提取JSON并使用parseDailyForecastData解析
-        QJsonObject json = QJsonObject::fromVariantMap(rawData);
-        QVariantMap result = parseDailyForecastData(json);
-        callback(result);
-    };
-    
-    sendRequest(url, dailyCallback);
+    // 新API的每日预报数据与周预报数据结构相同
+    getWeeklyForecast(cityName, callback);
 }
 
 void WeatherAPIClient::getDetailedWeatherInfo(const QString &cityName, std::function<void(const QVariantMap&)> callback)
 {
-    // 详细天气信息使用当前天气API，但包含更多字段
-    getCurrentWeather(cityName, [this, callback](const QVariantMap &data) {
-        if (data.contains("error")) {
-            callback(data);
-            return;
-        }
-        
-        // 可以在这里添加更多详细信息的处理
-        QVariantMap detailedData = data;
-        detailedData["isDetailed"] = true;
-        callback(detailedData);
+    getWeatherBundle(cityName, [this, callback, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
+        callback(bundle ? bundle->detailedInfo() : createErrorResponse(error, cityName));
     });
 }
 
 void WeatherAPIClient::getSunriseInfo(const QString &cityName, std::function<void(const QVariantMap&)> callback)
 {
-    // 日出日落信息包含在当前天气API中
-    getCurrentWeather(cityName, [this, callback](const QVariantMap &data) {
-        if (data.contains("error")) {
-            callback(data);
-            return;
-        }
-        
-        QVariantMap sunriseData;
-        sunriseData["cityName"] = data["cityName"];
-        sunriseData["sunrise"] = data.value("sunrise", "");
-        sunriseData["sunset"] = data.value("sunset", "");
-        sunriseData["timezone"] = data.value("timezone", 0);
-        callback(sunriseData);
+    getWeatherBundle(cityName, [this, callback, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
+        callback(bundle ? bundle->sunriseInfo() : createErrorResponse(error, cityName));
     });
 }
 
 void WeatherAPIClient::searchCities(const QString &query, std::function<void(const QVariantList&)> callback)
 {
-    // 使用本地城市代码映射进行搜索
+    searchCitiesPage(query, 0, kSearchPageSize, [callback](const QVariantMap &page) {
+        callback(page.value("results").toList());
+    });
+}
+
+void WeatherAPIClient::searchCitiesPage(const QString &query, int offset, int limit, std::function<void(const QVariantMap&)> callback)
+{
+    if (deferUntilDirectoryReady([this, query, offset, limit, callback]() { searchCitiesPage(query, offset, limit, callback); })) {
+        return;
+    }
+
+    // 纯字母输入按拼音/首字母前缀匹配（bj、beijing），否则在名称倒排索引上做子串搜索
+    // 连续输入时会话只在上一次的候选里过滤，并且只为本页结果构建QVariantMap
+    const CitySearchSession::Page page = m_searchSession->search(query, offset, limit);
+    const CityHierarchy &hierarchy = m_indexes->hierarchy;
+
     QVariantList results;
-    
-    for (auto it = m_cityCodeMap.begin(); it != m_cityCodeMap.end(); ++it) {
-        const QString &cityName = it.key();
-        if (cityName.contains(query, Qt::CaseInsensitive)) {
-            QVariantMap cityInfo;
-            cityInfo["name"] = cityName;
-            cityInfo["code"] = it.value();
-            results.append(cityInfo);
+    results.reserve(page.indices.size());
+    for (qsizetype i = 0; i < page.indices.size(); ++i) {
+        const qsizetype index = page.indices.at(i);
+        QVariantMap cityInfo;
+        cityInfo["name"] = m_cityDirectory.nameAt(index).toString();
+        cityInfo["code"] = m_cityDirectory.codeAt(index);
+        // 同名地点的fullName附带上级地名（如"通州区 (北京)"），界面按fullName加载即可区分
+        const quint32 node = hierarchy.nodeOfDirectoryIndex(index);
+        const quint32 parent = hierarchy.parentOf(node);
+        cityInfo["parent"] = parent != CityDirectoryData::kNoIndex ? hierarchy.nameAt(parent).toString() : QString();
+        cityInfo["fullName"] = hierarchy.isAmbiguous(m_cityDirectory.nameAt(index))
+            ? hierarchy.qualifiedName(node) : cityInfo["name"].toString();
+        if (page.approximate) {
+            cityInfo["distance"] = page.distances.at(i);
         }
+        results.append(cityInfo);
     }
-    
-    callback(results);
+
+    QVariantMap pageData;
+    pageData["query"] = query;
+    pageData["offset"] = qlonglong(page.offset);
+    pageData["total"] = qlonglong(page.total);
+    pageData["hasMore"] = page.offset + page.indices.size() < page.total;
+    pageData["approximate"] = page.approximate;
+    pageData["results"] = results;
+    callback(pageData);
 }
 
-void WeatherAPIClient::sendRequest(const QString &url, std::function<void(const QVariantMap&)> callback)
+QString WeatherAPIClient::codeForCity(const QString &cityName) const
 {
-    QNetworkRequest request;
-    request.setUrl(QUrl(url));
-    request.setHeader(QNetworkRequest::UserAgentHeader, "WeatherApp/1.0");
-    
-    QNetworkReply *reply = m_networkManager->get(request);
-    m_callbacks[reply] = callback;
-    
-    // 连接finished信号到槽函数
-    connect(reply, &QNetworkReply::finished, this, &WeatherAPIClient::onNetworkReplyFinished);
-    
-    qDebug() << "Sending request to:" << url;
+    // 通过层级索引解析，支持同名地点和"朝阳 (北京)"写法
+    if (!m_indexes) {
+        return QString();
+    }
+    const quint32 node = m_indexes->hierarchy.resolve(cityName);
+    if (node != CityDirectoryData::kNoIndex) {
+        return QString::number(m_indexes->hierarchy.codeAt(node));
+    }
+    // 英文名、旧式拼写或全拼（Beijing、Peking、"Beijing,CN"），一次哈希查找
+    const qsizetype index = m_indexes->aliasIndex.indexOf(cityName);
+    return index >= 0 ? m_cityDirectory.codeAt(index) : QString();
+}
+
+void WeatherAPIClient::fetchCityWeather(const QString &cityCode, WeatherRequestId requestId, BundleCallback callback)
+{
+    // 命中缓存时在当前调用栈内直接返回，不访问网络
+    if (CityWeatherBundlePtr cached = m_cache.lookup(cityCode)) {
+        qDebug() << "Cache hit for city code:" << cityCode;
+        m_liveRequests.remove(requestId);
+        callback(cached, QString());
+        return;
+    }
+
+    WeatherRequest<CityWeatherBundlePtr> request(
+        QUrl(buildCurrentWeatherUrl(cityCode)),
+        &WeatherAPIClient::parseWeatherResponse,
+        [this, cityCode, requestId, callback](const CityWeatherBundlePtr &bundle, const QString &error) {
+            m_liveRequests.remove(requestId);
+            // 只缓存成功的响应
+            if (bundle) {
+                m_cache.insert(cityCode, bundle);
+            }
+            callback(bundle, error);
+        },
+        requestId);
+    m_liveRequests[requestId] = sendRequest(std::move(request), m_inFlightWeather);
 }
 
 void WeatherAPIClient::sendRequestForList(const QString &url, std::function<void(const QVariantList&)> callback)
 {
-    QNetworkRequest request;
-    request.setUrl(QUrl(url));
-    request.setHeader(QNetworkRequest::UserAgentHeader, "WeatherApp/1.0");
-    
-    QNetworkReply *reply = m_networkManager->get(request);
-    m_listCallbacks[reply] = callback;
-    
-    connect(reply, &QNetworkReply::finished, this, &WeatherAPIClient::onNetworkReplyFinished);
-    
-    qDebug() << "Sending list request to:" << url;
+    WeatherRequest<QVariantList> request(
+        QUrl(url),
+        &WeatherAPIClient::parseSearchResponse,
+        [this, callback](const QVariantList &result, const QString &error) {
+            callback(error.isEmpty() ? result : createErrorListResponse(error));
+        });
+    sendRequest(std::move(request), m_inFlightSearch);
 }
 
-void WeatherAPIClient::onNetworkReplyFinished()
+template <typename Result>
+std::shared_ptr<WeatherRequest<Result>> WeatherAPIClient::sendRequest(WeatherRequest<Result> request,
+                                   QHash<QString, std::shared_ptr<WeatherRequest<Result>>> &inFlight)
 {
-    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) {
-        qDebug() << "No reply object found";
-        return;
+    const QString requestKey = request.url().toString();
+
+    // 相同URL的请求仍在进行中时，只追加等待者，不再发起新的请求（已取消的请求不再接收等待者）
+    if (auto pending = inFlight.value(requestKey); pending && !pending->isCompleted()) {
+        pending->mergeWaiters(std::move(request));
+        ++m_requestStats.coalesced;
+        qDebug() << "Coalesced request to:" << requestKey << "waiters:" << pending->waiterCount();
+        return pending;
     }
-    
-    qDebug() << "Network reply finished for URL:" << reply->url().toString();
-    qDebug() << "Reply error:" << reply->error() << reply->errorString();
-    
-    // 处理普通回调
-    if (m_callbacks.contains(reply)) {
-        auto callback = m_callbacks.take(reply);
-        
-        if (reply->error() != QNetworkReply::NoError) {
-            qDebug() << "Network error:" << reply->errorString();
-            callback(createErrorResponse(reply->errorString()));
-        } else {
-            QByteArray data = reply->readAll();
-            QJsonParseError parseError;
-            QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-            
-            if (parseError.error != QJsonParseError::NoError) {
-                qDebug() << "JSON parse error:" << parseError.errorString();
-                callback(createErrorResponse("Invalid JSON response"));
-            } else {
-                QJsonObject json = doc.object();
-                
-                // 检查API错误
-                if (json.contains("cod") && json["cod"].toInt() != 200) {
-                    QString errorMsg = json.value("message").toString();
-                    callback(createErrorResponse(errorMsg));
-                } else {
-                    // 根据URL判断数据类型并解析
-                    QString url = reply->url().toString();
-                    QVariantMap result;
-                    
-                    if (url.contains("/weather")) {
-                        result = parseCurrentWeatherData(json);
-                    } else if (url.contains("/forecast/daily")) {
-                        result = parseDailyForecastData(json);
-                    } else if (url.contains("/forecast")) {
-                        result = parseWeeklyForecastData(json);
-                    } else {
-                        result = parseCurrentWeatherData(json); // 默认解析
-                    }
-                    
-                    callback(result);
-                }
-            }
+
+    QNetworkRequest networkRequest(request.url());
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, "WeatherApp/1.0");
+
+    auto pending = std::make_shared<WeatherRequest<Result>>(std::move(request));
+    inFlight.insert(requestKey, pending);
+    ++m_requestStats.issued;
+
+    QNetworkReply *reply = m_networkManager->get(networkRequest);
+    // 所有等待者都取消后中止回复，不再占用带宽
+    pending->setAbort([reply = QPointer<QNetworkReply>(reply)]() {
+        if (reply) {
+            reply->abort();
         }
+    });
+
+    // 每个reply只连接一次，描述对象随lambda一起持有，无需按reply查表
+    connect(reply, &QNetworkReply::finished, this, [this, reply, pending, requestKey, &inFlight]() {
         reply->deleteLater();
-        return;
-    }
-    
-    // 处理列表回调
-    if (m_listCallbacks.contains(reply)) {
-        auto callback = m_listCallbacks.take(reply);
-        
+
+        // 已取消：不解析，只移出进行中列表
+        if (pending->isCompleted()) {
+            if (inFlight.value(requestKey) == pending) {
+                inFlight.remove(requestKey);
+            }
+            qDebug() << "Request cancelled:" << requestKey;
+            return;
+        }
+
+        // 完成前先移出进行中列表，回调里再次请求同一URL时会发起新请求
+        // 解析期间仍保留在列表中，新的相同请求继续合并
+        auto finish = [this, pending, requestKey, &inFlight](qint64 networkNs, const Result &result, const QString &error) {
+            if (inFlight.value(requestKey) == pending) {
+                inFlight.remove(requestKey);
+            }
+            pending->finish(result, error);
+            recordRequestFinished(requestKey, networkNs, pending->elapsedNs() - networkNs);
+        };
+
+        const qint64 networkNs = pending->elapsedNs();
         if (reply->error() != QNetworkReply::NoError) {
             qDebug() << "Network error:" << reply->errorString();
-            callback(createErrorListResponse(reply->errorString()));
-        } else {
-            QByteArray data = reply->readAll();
-            qDebug() << "Received search response:" << data;
-            
-            QJsonParseError parseError;
-            QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-            
-            if (parseError.error != QJsonParseError::NoError) {
-                qDebug() << "JSON parse error:" << parseError.errorString();
-                callback(createErrorListResponse("Invalid JSON response"));
-            } else {
-                // OpenWeather地理编码API直接返回数组
-                QJsonArray geocodesArray = doc.array();
-                qDebug() << "Geocodes array:" << geocodesArray;
-                
-                if (geocodesArray.isEmpty()) {
-                    qDebug() << "No cities found";
-                    callback(createErrorListResponse("No cities found"));
-                } else {
-                    QVariantList result = parseCitySearchData(geocodesArray);
-                    qDebug() << "Parsed search results:" << result;
-                    callback(result);
-                }
-            }
+            finish(networkNs, Result{}, reply->errorString());
+            return;
         }
-        reply->deleteLater();
-        return;
-    }
-    
-    // 如果reply不在任何回调映射中，仍然需要删除它
-    reply->deleteLater();
-}
 
+        // JSON解码和数据投影放到工作线程，GUI线程只接收最终的不可变结果
+        QFuture<typename WeatherRequest<Result>::Outcome> future = QtConcurrent::run(
+            &m_parsePool, &WeatherRequest<Result>::parse, pending->parser(), reply->readAll());
+        future.then(this, [finish, networkNs](const typename WeatherRequest<Result>::Outcome &outcome) {
+            finish(networkNs, outcome.result, outcome.error);
+        });
+    });
 
+    qDebug() << "Sending request to:" << requestKey;
+    return pending;
+}
 
-QVariantMap WeatherAPIClient::parseCurrentWeatherData(const QJsonObject &json)
+CityWeatherBundlePtr WeatherAPIClient::parseWeatherResponse(const QByteArray &data, QString *error)
 {
-    QVariantMap result;
-    QJsonObject data = json.value("data").toObject();
-    QJsonObject cityInfo = json.value("cityInfo").toObject();
-    QJsonArray forecast = data.value("forecast").toArray();
-    QJsonObject todayForecast = forecast.at(0).toObject();
-    
-    result["cityName"] = cityInfo.value("city").toString();
-    result["wendu"] = data.value("wendu").toString() + "°C";
-    result["shidu"] = data.value("shidu").toString();
-    result["pm25"] = QString::number(data.value("pm25").toDouble());
-    result["quality"] = data.value("quality").toString();
-    result["ganmao"] = data.value("ganmao").toString();
-    result["fx"] = todayForecast.value("fx").toString();
-    result["fl"] = todayForecast.value("fl").toString();
-    result["type"] = todayForecast.value("type").toString();
-    result["sunrise"] = todayForecast.value("sunrise").toString();
-    result["sunset"] = todayForecast.value("sunset").toString();
-    result["notice"] = todayForecast.value("notice").toString();
-
-    // 为了与你现有的数据模型兼容，我们还需要填充一些字段
-    result["temperature"] = result["wendu"];
-    result["weatherDescription"] = result["type"];
-    result["maxMinTemp"] = todayForecast.value("high").toString() + " / " + todayForecast.value("low").toString();
-
-    // 构建detailedInfo数据结构
-    QVariantMap detailedInfo;
-    detailedInfo["humidity"] = result["shidu"].toString();
-    detailedInfo["windSpeed"] = result["fx"].toString() + " " + result["fl"].toString(); // 风向+风力
-    detailedInfo["rainfall"] = "0mm"; // API不提供当前降雨量
-    detailedInfo["airQuality"] = result["quality"].toString();
-    detailedInfo["airPressure"] = result["pm25"].toString() + " μg/m³"; // 使用PM2.5数据代替气压
-    detailedInfo["uvIndex"] = "中等"; // 设置默认UV指数
-    result["detailedInfo"] = detailedInfo;
-
-    // 解析未来几天的预报
-    QVariantList weeklyForecastList;
-    for(int i = 0; i < forecast.size(); ++i) {
-        QVariantMap dayForecast;
-        QJsonObject forecastObj = forecast.at(i).toObject();
-        dayForecast["date"] = forecastObj.value("ymd").toString();
-        dayForecast["week"] = forecastObj.value("week").toString();
-        dayForecast["high"] = forecastObj.value("high").toString();
-        dayForecast["low"] = forecastObj.value("low").toString();
-        dayForecast["type"] = forecastObj.value("type").toString();
-        weeklyForecastList.append(dayForecast);
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        qDebug() << "JSON parse error:" << parseError.errorString();
+        *error = "Invalid JSON response";
+        return nullptr;
     }
-    result["weeklyForecast"] = weeklyForecastList;
 
-    return result;
+    QJsonObject json = doc.object();
+    // 检查API错误
+    if (json.contains("cod") && json["cod"].toInt() != 200) {
+        *error = json.value("message").toString();
+        return nullptr;
+    }
+
+    // 整个文档只解析一次，所有视图数据都从数据包投影
+    return CityWeatherBundle::fromJson(json);
 }
 
-QVariantMap WeatherAPIClient::parseWeeklyForecastData(const QJsonObject &json)
+QVariantList WeatherAPIClient::parseSearchResponse(const QByteArray &data, QString *error)
 {
-    QVariantMap result;
-    QJsonObject data = json.value("data").toObject();
-    QJsonObject cityInfo = json.value("cityInfo").toObject();
-    QJsonArray forecast = data.value("forecast").toArray();
-    
-    result["cityName"] = cityInfo.value("city").toString();
-    
-    QVariantList recentDaysName;
-    QVariantList recentDaysMaxMinTempreture;
-    QVariantList recentDaysWeatherDescriptionIcon;
-    QVariantList forecastList;
-    
-    // 处理预报数据（新API直接提供每日数据）
-    for (int i = 0; i < forecast.size() && i < 7; ++i) {
-        QJsonObject dayData = forecast.at(i).toObject();
-        
-        // 获取日期和星期
-        QString week = dayData.value("week").toString();
-        QString ymd = dayData.value("ymd").toString();
-        
-        // 格式化日期显示
-        if (i == 0) {
-            recentDaysName.append("今天");
-        } else if (i == 1) {
-            recentDaysName.append("明天");
-        } else {
-            recentDaysName.append(week);
-        }
-        
-        // 获取温度信息
-        QString high = dayData.value("high").toString();
-        QString low = dayData.value("low").toString();
-        recentDaysMaxMinTempreture.append(high + " / " + low);
-        
-        // 获取天气类型并转换为图标
-        QString type = dayData.value("type").toString();
-        QString weatherIcon = "🌤️"; // 默认图标
-        
-        if (type.contains("晴")) weatherIcon = "☀️";
-        else if (type.contains("多云")) weatherIcon = "☁️";
-        else if (type.contains("阴")) weatherIcon = "☁️";
-        else if (type.contains("雨")) weatherIcon = "🌧️";
-        else if (type.contains("雪")) weatherIcon = "❄️";
-        else if (type.contains("雾")) weatherIcon = "🌫️";
-        else if (type.contains("雷")) weatherIcon = "⛈️";
-        
-        recentDaysWeatherDescriptionIcon.append(weatherIcon);
-        
-        // 保留原始数据格式
-        QVariantMap dayForecast;
-        dayForecast["date"] = ymd;
-        dayForecast["week"] = week;
-        dayForecast["high"] = high;
-        dayForecast["low"] = low;
-        dayForecast["type"] = type;
-        dayForecast["icon"] = weatherIcon;
-        forecastList.append(dayForecast);
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        qDebug() << "JSON parse error:" << parseError.errorString();
+        *error = "Invalid JSON response";
+        return QVariantList();
     }
-    
-    // 设置UI期望的数据格式
-    QVariantMap weeklyForecast;
-    weeklyForecast["recentDaysName"] = recentDaysName;
-    weeklyForecast["recentDaysMaxMinTempreture"] = recentDaysMaxMinTempreture;
-    weeklyForecast["recentDaysWeatherDescriptionIcon"] = recentDaysWeatherDescriptionIcon;
-    
-    result["weeklyForecast"] = weeklyForecast;
-    result["forecast"] = forecastList;
-    
-    qDebug() << "Parsed weekly forecast with" << recentDaysName.size() << "days";
-    
-    return result;
+
+    // OpenWeather地理编码API直接返回数组
+    QJsonArray geocodesArray = doc.array();
+    if (geocodesArray.isEmpty()) {
+        qDebug() << "No cities found";
+        *error = "No cities found";
+        return QVariantList();
+    }
+    return parseCitySearchData(geocodesArray);
 }
 
-QVariantMap WeatherAPIClient::parseDailyForecastData(const QJsonObject &json)
+void WeatherAPIClient::recordRequestFinished(const QString &requestKey, qint64 networkNs, qint64 dispatchNs)
 {
-    // 新API的每日预报数据与周预报数据结构相同，直接复用解析逻辑
-    QVariantMap result = parseWeeklyForecastData(json);
-    
-    qDebug() << "Parsed daily forecast data for city:" << result.value("cityName").toString();
-    
-    return result;
+    ++m_requestStats.completed;
+    m_requestStats.totalNetworkNs += networkNs;
+    m_requestStats.totalDispatchNs += dispatchNs;
+    qDebug() << "Request finished:" << requestKey
+             << "network ms:" << networkNs / 1000000
+             << "parse+dispatch us:" << dispatchNs / 1000;
 }
 
-QVariantMap WeatherAPIClient::parseDetailedWeatherData(const QJsonObject &json)
+QVariantMap WeatherAPIClient::requestStats() const
 {
-    // 详细天气信息基于当前天气数据
-    return parseCurrentWeatherData(json);
+    QVariantMap result;
+    result["issued"] = m_requestStats.issued;
+    result["coalesced"] = m_requestStats.coalesced;
+    result["completed"] = m_requestStats.completed;
+    result["cancelled"] = m_requestStats.cancelled;
+    if (m_requestStats.completed > 0) {
+        result["avgNetworkMs"] = double(m_requestStats.totalNetworkNs) / m_requestStats.completed / 1e6;
+        result["avgDispatchUs"] = double(m_requestStats.totalDispatchNs) / m_requestStats.completed / 1e3;
+    }
+    return result;
 }
 
-QVariantMap WeatherAPIClient::parseSunriseData(const QJsonObject &json)
+QVariantMap WeatherAPIClient::directoryStats() const
 {
+    const qsizetype tableBytes = CityDirectory::tableFootprint();
+    const qsizetype searchIndexBytes = m_indexes ? m_indexes->searchIndex.memoryFootprint() : 0;
+    const qsizetype hierarchyBytes = m_indexes ? m_indexes->hierarchy.memoryFootprint() : 0;
+
     QVariantMap result;
-    
-    result["cityName"] = json.value("name").toString();
-    
-    QJsonObject sys = json.value("sys").toObject();
-    qint64 sunriseTimestamp = sys.value("sunrise").toInt();
-    qint64 sunsetTimestamp = sys.value("sunset").toInt();
-    
-    result["sunrise"] = QDateTime::fromSecsSinceEpoch(sunriseTimestamp).toString("hh:mm");
-    result["sunset"] = QDateTime::fromSecsSinceEpoch(sunsetTimestamp).toString("hh:mm");
-    result["timezone"] = json.value("timezone").toInt();
-    
+    result["ready"] = isDirectoryReady();
+    result["cities"] = qlonglong(m_cityDirectory.count());
+    result["nodes"] = qlonglong(m_indexes ? m_indexes->hierarchy.nodeCount() : 0);
+    result["tableBytes"] = qlonglong(tableBytes);
+    result["searchIndexBytes"] = qlonglong(searchIndexBytes);
+    result["hierarchyBytes"] = qlonglong(hierarchyBytes);
+    result["totalBytes"] = qlonglong(tableBytes + searchIndexBytes + hierarchyBytes);
+    // 原QMap<QString, QString>存放同样的名称 -> 代码映射时的占用，按分配器行为估算而非实测
+    // （实测值见tools/citybench），不能与上面的字节数直接相加比较
+    result["legacyMapEstimatedBytes"] = qlonglong(CityDirectory::legacyMapFootprint());
     return result;
 }
 
@@ -569,97 +570,3 @@ QVariantList WeatherAPIClient::createErrorListResponse(const QString &error)
     errorResults.append(errorData);
     return errorResults;
 }
-
-QString WeatherAPIClient::translateCityName(const QString &englishName)
-{
-    // 常见城市中英文映射
-    static QHash<QString, QString> cityNameMap = {
-        {"Beijing", "北京"},
-        {"Shanghai", "上海"},
-        {"Guangzhou", "广州"},
-        {"Shenzhen", "深圳"},
-        {"Hangzhou", "杭州"},
-        {"Nanjing", "南京"},
-        {"Wuhan", "武汉"},
-        {"Chengdu", "成都"},
-        {"Xi'an", "西安"},
-        {"Chongqing", "重庆"},
-        {"Tianjin", "天津"},
-        {"Shenyang", "沈阳"},
-        {"Dalian", "大连"},
-        {"Qingdao", "青岛"},
-        {"Jinan", "济南"},
-        {"Harbin", "哈尔滨"},
-        {"Changchun", "长春"},
-        {"Kunming", "昆明"},
-        {"Xiamen", "厦门"},
-        {"Fuzhou", "福州"},
-        {"Hefei", "合肥"},
-        {"Nanchang", "南昌"},
-        {"Changsha", "长沙"},
-        {"Zhengzhou", "郑州"},
-        {"Taiyuan", "太原"},
-        {"Shijiazhuang", "石家庄"},
-        {"Hohhot", "呼和浩特"},
-        {"Urumqi", "乌鲁木齐"},
-        {"Lhasa", "拉萨"},
-        {"Yinchuan", "银川"},
-        {"Xining", "西宁"},
-        {"Lanzhou", "兰州"},
-        {"Guiyang", "贵阳"},
-        {"Nanning", "南宁"},
-        {"Haikou", "海口"},
-        {"Sanya", "三亚"},
-        // 国际城市
-        {"New York", "纽约"},
-        {"London", "伦敦"},
-        {"Paris", "巴黎"},
-        {"Tokyo", "东京"},
-        {"Seoul", "首尔"},
-        {"Singapore", "新加坡"},
-        {"Sydney", "悉尼"},
-        {"Melbourne", "墨尔本"},
-        {"Toronto", "多伦多"},
-        {"Vancouver", "温哥华"},
-        {"Los Angeles", "洛杉矶"},
-        {"San Francisco", "旧金山"},
-        {"Chicago", "芝加哥"},
-        {"Washington", "华盛顿"},
-        {"Moscow", "莫斯科"},
-        {"Berlin", "柏林"},
-        {"Rome", "罗马"},
-        {"Madrid", "马德里"},
-        {"Amsterdam", "阿姆斯特丹"},
-        {"Bangkok", "曼谷"},
-        {"Mumbai", "孟买"},
-        {"Dubai", "迪拜"}
-    };
-    
-    // 如果找到映射则返回中文名，否则返回原英文名
-    return cityNameMap.value(englishName, englishName);
-}
-
-void WeatherAPIClient::loadCityCodes()
-{
-    QFile file(":/WeatherAPP/citycode-2019-08-23.json"); // 使用正确的资源路径
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning("Couldn't open citycode file.");
-        return;
-    }
-
-    QByteArray cityData = file.readAll();
-    QJsonDocument cityDoc = QJsonDocument::fromJson(cityData);
-    QJsonArray cityArr = cityDoc.array();
-
-    int loadedCount = 0;
-    for (const QJsonValue &value : cityArr) {
-        QJsonObject cityObj = value.toObject();
-        QString cityName = cityObj["city_name"].toString();
-        QString cityCode = cityObj["city_code"].toString();
-        if (!cityName.isEmpty() && !cityCode.isEmpty()) {
-            m_cityCodeMap[cityName] = cityCode;
-            loadedCount++;
-        }
-    }
-    qDebug() << "Loaded" << loadedCount << "cities from citycode file.";
-}
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "../../include/services/WeatherDataBus.hpp"
+#include <QCoreApplication>
+#include <QDebug>
+
+WeatherDataBus *WeatherDataBus::shared()
+{
+    static QPointer<WeatherDataBus> instance;
+    if (!instance) {
+        instance = new WeatherDataBus(QCoreApplication::instance());
+    }
+    return instance;
+}
+
+WeatherDataBus::WeatherDataBus(QObject *parent) : QObject(parent)
+{
+}
+
+WeatherDataBus::SubscriptionId WeatherDataBus::subscribeBundle(const QString &cityName, QObject *receiver,
+                                                               std::function<void(const CityWeatherBundlePtr &)> handler,
+                                                               bool replayLatest)
+{
+    return addSubscription(BundleKind, cityName, receiver,
+                           [handler](const CityWeatherBundlePtr &bundle, const QString &) { handler(bundle); },
+                           replayLatest);
+}
+
+WeatherDataBus::SubscriptionId WeatherDataBus::subscribeCurrent(const QString &cityName, QObject *receiver,
+                                                                std::function<void(const CurrentConditions &)> handler,
+                                                                bool replayLatest)
+{
+    return addSubscription(CurrentKind, cityName, receiver,
+                           [handler](const CityWeatherBundlePtr &bundle, const QString &) { handler(bundle->current()); },
+                           replayLatest);
+}
+
+WeatherDataBus::SubscriptionId WeatherDataBus::subscribeForecast(const QString &cityName, QObject *receiver,
+                                                                 std::function<void(const QList<DailyForecast> &)> handler,
+                                                                 bool replayLatest)
+{
+    return addSubscription(ForecastKind, cityName, receiver,
+                           [handler](const CityWeatherBundlePtr &bundle, const QString &) { handler(bundle->days()); },
+                           replayLatest);
+}
+
+WeatherDataBus::SubscriptionId WeatherDataBus::subscribeErrors(const QString &cityName, QObject *receiver,
+                                                               std::function<void(const QString &)> handler)
+{
+    return addSubscription(ErrorKind, cityName, receiver,
+                           [handler](const CityWeatherBundlePtr &, const QString &error) { handler(error); },
+                           false);
+}
+
+WeatherDataBus::SubscriptionId WeatherDataBus::addSubscription(Kind kind, const QString &cityName, QObject *receiver,
+                                                               Handler handler, bool replayLatest)
+{
+    if (cityName.isEmpty() || !receiver) {
+        return 0;
+    }
+
+    const SubscriptionId id = ++m_nextId;
+    const CityWeatherBundlePtr current = replayLatest ? latest(cityName) : nullptr;
+    m_subscriptions[kind][cityName].append({id, receiver, handler, current});
+    m_keys.insert(id, {kind, cityName});
+
+    // 每个接收者只连接一次destroyed
+    auto it = m_byReceiver.find(receiver);
+    if (it == m_byReceiver.end()) {
+        it = m_byReceiver.insert(receiver, {});
+        connect(receiver, &QObject::destroyed, this, [this, receiver]() { onReceiverDestroyed(receiver); });
+    }
+    it->append(id);
+
+    // 已发布过的数据立即投递，订阅者不必另外查询
+    if (current) {
+        handler(current, QString());
+    }
+    return id;
+}
+
+void WeatherDataBus::unsubscribe(SubscriptionId id)
+{
+    auto keyIt = m_keys.find(id);
+    if (keyIt == m_keys.end()) {
+        return;
+    }
+    const Key key = keyIt.value();
+    m_keys.erase(keyIt);
+
+    auto listIt = m_subscriptions[key.kind].find(key.cityName);
+    if (listIt == m_subscriptions[key.kind].end()) {
+        return;
+    }
+    QObject *receiver = nullptr;
+    for (qsizetype i = 0; i < listIt->size(); ++i) {
+        if (listIt->at(i).id == id) {
+            receiver = listIt->at(i).receiver.data();
+            listIt->removeAt(i);
+            break;
+        }
+    }
+    if (listIt->isEmpty()) {
+        m_subscriptions[key.kind].erase(listIt);
+        releaseCity(key.cityName);
+    }
+
+    if (receiver) {
+        auto receiverIt = m_byReceiver.find(receiver);
+        if (receiverIt != m_byReceiver.end()) {
+            receiverIt->removeOne(id);
+            if (receiverIt->isEmpty()) {
+                m_byReceiver.erase(receiverIt);
+                disconnect(receiver, &QObject::destroyed, this, nullptr);
+            }
+        }
+    }
+}
+
+void WeatherDataBus::unsubscribeAll(QObject *receiver)
+{
+    const QList<SubscriptionId> ids = m_byReceiver.value(receiver);
+    for (SubscriptionId id : ids) {
+        unsubscribe(id);
+    }
+}
+
+void WeatherDataBus::onReceiverDestroyed(QObject *receiver)
+{
+    // 对象已在析构中，QPointer已失效，按id逐个移除
+    const QList<SubscriptionId> ids = m_byReceiver.take(receiver);
+    for (SubscriptionId id : ids) {
+        const Key key = m_keys.take(id);
+        auto listIt = m_subscriptions[key.kind].find(key.cityName);
+        if (listIt == m_subscriptions[key.kind].end()) {
+            continue;
+        }
+        listIt->removeIf([id](const Subscription &subscription) { return subscription.id == id; });
+        if (listIt->isEmpty()) {
+            m_subscriptions[key.kind].erase(listIt);
+            releaseCity(key.cityName);
+        }
+    }
+}
+
+CityWeatherBundlePtr WeatherDataBus::latest(const QString &cityName)
+{
+    const auto it = m_latest.find(cityName);
+    if (it == m_latest.end()) {
+        return nullptr;
+    }
+    CityWeatherBundlePtr bundle = it.value().lock();
+    if (!bundle) {
+        // 数据包已没有持有者，记录不再有用
+        m_latest.erase(it);
+    }
+    return bundle;
+}
+
+void WeatherDataBus::releaseCity(const QString &cityName)
+{
+    for (const auto &subscriptions : m_subscriptions) {
+        if (subscriptions.contains(cityName)) {
+            return;
+        }
+    }
+    // 城市的最后一个订阅已退订，不再保留它最后发布的数据包
+    m_latest.remove(cityName);
+}
+
+void WeatherDataBus::publish(const QString &cityName, const CityWeatherBundlePtr &bundle)
+{
+    if (cityName.isEmpty() || !bundle) {
+        return;
+    }
+    m_latest.insert(cityName, bundle);
+
+    deliver(BundleKind, cityName, bundle, QString());
+    deliver(CurrentKind, cityName, bundle, QString());
+    deliver(ForecastKind, cityName, bundle, QString());
+}
+
+void WeatherDataBus::publishError(const QString &cityName, const QString &error)
+{
+    deliver(ErrorKind, cityName, nullptr, error);
+}
+
+void WeatherDataBus::deliver(Kind kind, const QString &cityName, const CityWeatherBundlePtr &bundle, const QString &error)
+{
+    const auto it = m_subscriptions[kind].find(cityName);
+    if (it == m_subscriptions[kind].end()) {
+        return;
+    }
+
+    // 先选出需要投递的订阅：命中缓存时各层拿到的是同一个数据包，已经收到过的订阅跳过
+    QList<std::pair<SubscriptionId, Handler>> targets;
+    for (Subscription &subscription : *it) {
+        if (!subscription.receiver) {
+            continue;
+        }
+        if (bundle) {
+            if (subscription.lastDelivered.lock() == bundle) {
+                continue;
+            }
+            subscription.lastDelivered = bundle;
+        }
+        targets.append({subscription.id, subscription.handler});
+    }
+
+    // 回调中退订或新订阅不影响本次投递；本次投递中已被退订的跳过
+    for (const auto &[id, handler] : targets) {
+        if (m_keys.contains(id)) {
+            handler(bundle, error);
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include "../../include/services/WeatherDataService.hpp"
 #include "../../include/services/WeatherAPIClient.hpp"
+#include "../../include/services/WeatherDataBus.hpp"
 #include <QTimer>
 #include <QDebug>
 #include <QJSValue>
@@ -8,14 +9,54 @@
 #include <QQmlContext>
 
 WeatherDataService::WeatherDataService(QObject *parent) : QObject(parent)
-    , m_apiClient(new WeatherAPIClient(this))
+    , m_apiClient(WeatherAPIClient::shared()) // 所有服务实例共用一个客户端（连接池、城市目录、缓存）
 {
     // 设置API密钥 - 在实际应用中应该从配置文件或环境变量读取
     // m_apiClient->setApiKey("your_openweathermap_api_key_here");
+
+    // 城市目录在后台加载，转发就绪信号；就绪前发起的查询由客户端排队
+    connect(m_apiClient, &WeatherAPIClient::directoryReady, this, &WeatherDataService::directoryReady);
+}
+
+bool WeatherDataService::isDirectoryReady() const
+{
+    return m_apiClient->isDirectoryReady();
 }
 
 WeatherDataService::~WeatherDataService() = default;
 
+WeatherRequestId WeatherDataService::fetchBundle(const QString &cityName, BundleCallback callback)
+{
+    if (!validateCityName(cityName)) {
+        QTimer::singleShot(0, this, [callback]() { callback(nullptr, "Invalid city name"); });
+        return 0;
+    }
+    return requestBundle(cityName, std::move(callback));
+}
+
+WeatherRequestId WeatherDataService::requestBundle(const QString &cityName, BundleCallback callback)
+{
+    // 结果先按城市发布到数据总线（只投递给订阅了该城市的对象），再交给调用方
+    // 被取消的请求不会回调，也就不会发布
+    return m_apiClient->getWeatherBundle(cityName, guarded([cityName, callback](const CityWeatherBundlePtr &bundle, const QString &error) {
+        if (bundle) {
+            WeatherDataBus::shared()->publish(cityName, bundle);
+        } else {
+            WeatherDataBus::shared()->publishError(cityName, error);
+        }
+        if (callback) {
+            callback(bundle, error);
+        }
+    }));
+}
+
+void WeatherDataService::cancelRequest(WeatherRequestId requestId)
+{
+    if (requestId != 0) {
+        m_apiClient->cancel(requestId);
+    }
+}
+
 
 
 void WeatherDataService::callLater(std::function<void()> func, int delayMs){
@@ -34,89 +75,24 @@ void WeatherDataService::getCityWeather(const QString &cityName,const QJSValue &
         errorData["error"] = "Invalid city name";
         
         // 使用安全的回调处理
-        QTimer::singleShot(0, this, [this, callback, errorData]() {
-            try {
-                QQmlEngine* engine = qmlEngine(this);
-                if (!engine) {
-                    engine = qmlContext(this) ? qmlContext(this)->engine() : nullptr;
-                }
-                
-                if (engine && callback.isCallable()) {
-                    QJSValueList args;
-                    args << engine->toScriptValue(errorData);
-                    const_cast<QJSValue&>(callback).call(args);
-                } else if (callback.isCallable()) {
-                    qDebug() << "QML engine is null, attempting direct callback";
-                    const_cast<QJSValue&>(callback).call(QJSValueList() << QJSValue());
-                }
-            } catch (const std::exception& e) {
-                qDebug() << "Exception in getCityWeather callback:" << e.what();
-            } catch (...) {
-                qDebug() << "Unknown exception in getCityWeather callback";
-            }
-        });
-        
-        qDebug() << "Emitting dataLoaded with error data:" << errorData;
-        emit dataLoaded(errorData);
+        QTimer::singleShot(0, this, [this, callback, errorData]() { invokeCallback(callback, errorData); });
         return;
     }
     
     qDebug() << "Requesting weather data from API client for city:" << cityName;
-    // 使用WeatherAPIClient获取真实天气数据
-    m_apiClient->getCurrentWeather(cityName, [this, callback, cityName](const QVariantMap &data) {
-        qDebug() << "WeatherDataService received API response for city:" << cityName << "Data:" << data;
-        
-        // 构建正确的数据结构
-        QVariantMap processedData = data;
-        
-        // 由于API已经在parseCurrentWeatherData中构建了detailedInfo，这里不需要重复构建
-        // 直接使用API返回的detailedInfo数据
-        if (!data.contains("detailedInfo")) {
-            // 如果API没有返回detailedInfo，则构建一个默认的
-            QVariantMap detailedInfo;
-            detailedInfo["humidity"] = data.value("shidu", "--").toString();
-            detailedInfo["windSpeed"] = data.value("fl", "--").toString();
-            detailedInfo["rainfall"] = "0mm";
-            detailedInfo["airQuality"] = data.value("quality", "--").toString();
-            detailedInfo["airPressure"] = "--hPa";
-            detailedInfo["uvIndex"] = "--";
-            processedData["detailedInfo"] = detailedInfo;
+    // 数据通过数据总线投递给订阅了该城市的对象，这里只处理脚本回调
+    requestBundle(cityName, [this, callback, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
+        // 只有脚本回调需要QVariantMap，没有回调时不做转换
+        if (!callback.isCallable()) {
+            return;
         }
-        
-        // 构建sunriseInfo结构
-        QVariantMap sunriseInfo;
-        sunriseInfo["sunrise"] = data.value("sunrise", "--:--");
-        sunriseInfo["sunset"] = data.value("sunset", "--:--");
-        sunriseInfo["timezone"] = data.value("timezone", 0);
-        processedData["sunriseInfo"] = sunriseInfo;
-        
-        qDebug() << "Processed data with detailedInfo and sunriseInfo:" << processedData;
-        
-        // 使用安全的回调处理
-        QTimer::singleShot(0, this, [this, callback, processedData]() {
-            try {
-                QQmlEngine* engine = qmlEngine(this);
-                if (!engine) {
-                    engine = qmlContext(this) ? qmlContext(this)->engine() : nullptr;
-                }
-                
-                if (engine && callback.isCallable()) {
-                    QJSValueList args;
-                    args << engine->toScriptValue(processedData);
-                    const_cast<QJSValue&>(callback).call(args);
-                } else if (callback.isCallable()) {
-                    qDebug() << "QML engine is null, attempting direct callback";
-                    const_cast<QJSValue&>(callback).call(QJSValueList() << QJSValue());
-                }
-            } catch (const std::exception& e) {
-                qDebug() << "Exception in getCityWeather callback:" << e.what();
-            } catch (...) {
-                qDebug() << "Unknown exception in getCityWeather callback";
-            }
-        });
-        
-        qDebug() << "Emitting dataLoaded with processed weather data:" << processedData;
-        emit dataLoaded(processedData);
+        if (!bundle) {
+            qDebug() << "Weather request failed for city:" << cityName << error;
+            invokeCallback(callback, QVariantMap{{"cityName", cityName}, {"error", error}});
+            return;
+        }
+        const QVariantMap data = bundle->currentWeather();
+        QTimer::singleShot(0, this, [this, callback, data]() { invokeCallback(callback, data); });
     });
 }
 
@@ -126,56 +102,22 @@ void WeatherDataService::getWeeklyForecast(const QString &cityName, const QJSVal
         QVariantMap errorData;
         errorData["cityName"] = cityName;
         errorData["error"] = "Invalid city name";
-        
-        if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(errorData);
-            const_cast<QJSValue&>(callback).call(args);
-        }
+        invokeCallback(callback, errorData);
         return;
     }
     
     // 使用WeatherAPIClient获取周天气预报
-    m_apiClient->getWeeklyForecast(cityName, [this, callback](const QVariantMap &data) {
-        // 发出dataLoaded信号，让AppStateManager能够接收到数据
-        emit dataLoaded(data);
-        
-        // 如果有回调函数，也调用它
+    requestBundle(cityName, [this, callback, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
         if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(data);
-            const_cast<QJSValue&>(callback).call(args);
+            invokeCallback(callback, bundle ? bundle->weeklyForecast() : QVariantMap{{"cityName", cityName}, {"error", error}});
         }
     });
 }
 
 // 获取指定城市的每日天气预报
 void WeatherDataService::getDailyForecast(const QString &cityName, const QJSValue &callback) {
-    if (!validateCityName(cityName)) {
-        QVariantMap errorData;
-        errorData["cityName"] = cityName;
-        errorData["error"] = "Invalid city name";
-        
-        if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(errorData);
-            const_cast<QJSValue&>(callback).call(args);
-        }
-        return;
-    }
-    
-    // 使用WeatherAPIClient获取每日天气预报
-    m_apiClient->getDailyForecast(cityName, [this, callback](const QVariantMap &data) {
-        // 发出dataLoaded信号，让AppStateManager能够接收到数据
-        emit dataLoaded(data);
-        
-        // 如果有回调函数，也调用它
-        if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(data);
-            const_cast<QJSValue&>(callback).call(args);
-        }
-    });
+    // 新API的每日预报与周预报来自同一个数据包
+    getWeeklyForecast(cityName, callback);
 }
 // 获取指定城市的详细天气信息
 void WeatherDataService::getDetailedWeatherInfo(const QString &cityName, const QJSValue &callback) {
@@ -183,21 +125,14 @@ void WeatherDataService::getDetailedWeatherInfo(const QString &cityName, const Q
         QVariantMap errorData;
         errorData["cityName"] = cityName;
         errorData["error"] = "Invalid city name";
-        
-        if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(errorData);
-            const_cast<QJSValue&>(callback).call(args);
-        }
+        invokeCallback(callback, errorData);
         return;
     }
     
     // 使用WeatherAPIClient获取详细天气信息
-    m_apiClient->getDetailedWeatherInfo(cityName, [this, callback](const QVariantMap &data) {
+    requestBundle(cityName, [this, callback, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
         if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(data);
-            const_cast<QJSValue&>(callback).call(args);
+            invokeCallback(callback, bundle ? bundle->detailedInfo() : QVariantMap{{"cityName", cityName}, {"error", error}});
         }
     });
 }
@@ -208,25 +143,27 @@ void WeatherDataService::getSunriseInfo(const QString &cityName, const QJSValue
         QVariantMap errorData;
         errorData["cityName"] = cityName;
         errorData["error"] = "Invalid city name";
-        
-        if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(errorData);
-            const_cast<QJSValue&>(callback).call(args);
-        }
+        invokeCallback(callback, errorData);
         return;
     }
     
     // 使用WeatherAPIClient获取日出日落信息
-    m_apiClient->getSunriseInfo(cityName, [this, callback](const QVariantMap &data) {
+    requestBundle(cityName, [this, callback, cityName](const CityWeatherBundlePtr &bundle, const QString &error) {
         if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(data);
-            const_cast<QJSValue&>(callback).call(args);
+            invokeCallback(callback, bundle ? bundle->sunriseInfo() : QVariantMap{{"cityName", cityName}, {"error", error}});
         }
     });
 }
 
+// 分页搜索城市，适合边输入边联想时按需加载更多结果
+void WeatherDataService::searchCitiesPage(const QString &query, int offset, int limit, const QJSValue &callback) {
+    m_apiClient->searchCitiesPage(query, offset, limit, guarded([this, callback](const QVariantMap &page) {
+        emit searchResultsReady(page.value("results").toList());
+        // 服务可能由C++创建，没有QML引擎，统一交给invokeCallback处理
+        invokeCallback(callback, page);
+    }));
+}
+
 // 根据查询字符串搜索城市
 void WeatherDataService::searchCities(const QString &query, const QJSValue &callback) {
     if (query.trimmed().isEmpty()) {
@@ -235,16 +172,12 @@ void WeatherDataService::searchCities(const QString &query, const QJSValue &call
         errorData["error"] = "Empty search query";
         errorResults.append(errorData);
         
-        if (callback.isCallable()) {
-            QJSValueList args;
-            args << qmlEngine(this)->toScriptValue(errorResults);
-            const_cast<QJSValue&>(callback).call(args);
-        }
+        invokeCallback(callback, errorResults);
         return;
     }
     
     // 使用WeatherAPIClient搜索城市
-    m_apiClient->searchCities(query, [this, callback](const QVariantList &results) {
+    m_apiClient->searchCities(query, guarded([this, callback](const QVariantList &results) {
         // 总是发射信号，无论是否有回调
         emit searchResultsReady(results);
         
@@ -286,7 +219,7 @@ void WeatherDataService::searchCities(const QString &query, const QJSValue &call
                 qDebug() << "Unknown exception in search callback";
             }
         }
-    });
+    }));
 }
 
 
@@ -299,6 +232,30 @@ void WeatherDataService::searchCities(const QString &query, const QJSValue &call
 
 
 
+// 调用QML回调：只在这里把数据转换为脚本值
+void WeatherDataService::invokeCallback(const QJSValue &callback, const QVariant &value)
+{
+    if (!callback.isCallable()) {
+        return;
+    }
+    QQmlEngine *engine = qmlEngine(this);
+    if (!engine) {
+        engine = qmlContext(this) ? qmlContext(this)->engine() : nullptr;
+    }
+    try {
+        if (engine) {
+            const_cast<QJSValue&>(callback).call(QJSValueList() << engine->toScriptValue(value));
+        } else {
+            qDebug() << "QML engine is null, attempting direct callback";
+            const_cast<QJSValue&>(callback).call(QJSValueList() << QJSValue());
+        }
+    } catch (const std::exception& e) {
+        qDebug() << "Exception in callback:" << e.what();
+    } catch (...) {
+        qDebug() << "Unknown exception in callback";
+    }
+}
+
 bool WeatherDataService::validateCityName(const QString &cityName){
     return !cityName.trimmed().isEmpty();
 }
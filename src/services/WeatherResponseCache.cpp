@@ -0,0 +1,106 @@
+#include "../../include/services/WeatherResponseCache.hpp"
+#include <QDebug>
+
+namespace {
+
+// 字符串的粗略内存估算（数据头 + UTF-16内容）
+qint64 estimateStringCost(const QString &text)
+{
+    return 24 + text.size() * qint64(sizeof(QChar));
+}
+
+}
+
+WeatherResponseCache::WeatherResponseCache(qint64 maxBytes, int ttlMs)
+    : m_entries(maxBytes)
+    , m_defaultTtlMs(ttlMs)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+CityWeatherBundlePtr WeatherResponseCache::lookup(const QString &cityCode)
+{
+    // object()会把命中的条目移动到LRU队首
+    Entry *entry = m_entries.object(cityCode);
+    if (entry && entry->expiry.hasExpired()) {
+        m_entries.remove(cityCode);
+        entry = nullptr;
+    }
+
+    if (!entry) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    return entry->bundle;
+}
+
+void WeatherResponseCache::insert(const QString &cityCode, const CityWeatherBundlePtr &bundle, int ttlMs)
+{
+    if (!bundle) return;
+
+    auto *entry = new Entry;
+    entry->bundle = bundle;
+    entry->expiry = QDeadlineTimer(ttlMs < 0 ? m_defaultTtlMs : ttlMs);
+
+    // 超出预算的单条数据会被QCache直接丢弃（并删除entry）
+    const qint64 cost = estimateCost(*bundle);
+    if (!m_entries.insert(cityCode, entry, cost)) {
+        qDebug() << "WeatherResponseCache: entry for" << cityCode << "exceeds memory budget, cost:" << cost;
+    }
+}
+
+void WeatherResponseCache::remove(const QString &cityCode)
+{
+    m_entries.remove(cityCode);
+}
+
+void WeatherResponseCache::clear()
+{
+    m_entries.clear();
+}
+
+void WeatherResponseCache::setMaxBytes(qint64 maxBytes)
+{
+    m_entries.setMaxCost(maxBytes);
+}
+
+void WeatherResponseCache::setDefaultTtl(int ttlMs)
+{
+    m_defaultTtlMs = ttlMs;
+}
+
+QVariantMap WeatherResponseCache::stats() const
+{
+    QVariantMap result;
+    result["hits"] = m_hits;
+    result["misses"] = m_misses;
+    result["entries"] = qint64(m_entries.count());
+    result["totalBytes"] = qint64(m_entries.totalCost());
+    result["maxBytes"] = qint64(m_entries.maxCost());
+    result["defaultTtlMs"] = m_defaultTtlMs;
+    return result;
+}
+
+qint64 WeatherResponseCache::estimateCost(const CityWeatherBundle &bundle)
+{
+    // 直接按类型化字段估算，不为了计费去构建QVariantMap投影
+    const CurrentConditions &current = bundle.current();
+    qint64 cost = sizeof(CityWeatherBundle);
+    for (const QString *text : {&current.cityName, &current.type, &current.icon, &current.ganmao, &current.notice,
+                                &current.details.airQuality, &current.details.windDirection,
+                                &current.details.windPower, &current.details.uvIndex,
+                                &current.sun.sunrise, &current.sun.sunset}) {
+        cost += estimateStringCost(*text);
+    }
+    for (const DailyForecast &day : current.forecast) {
+        cost += sizeof(DailyForecast);
+        for (const QString *text : {&day.date, &day.week, &day.high, &day.low, &day.type, &day.icon,
+                                    &day.windDirection, &day.windPower, &day.sunrise, &day.sunset, &day.notice}) {
+            cost += estimateStringCost(*text);
+        }
+    }
+    return cost;
+}
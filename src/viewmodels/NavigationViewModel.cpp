@@ -35,6 +35,7 @@ void NavigationViewModel::initialize(QObject *stateManager)
         // 同步当前视图状态
         m_currentView = m_appStateManager->currentViewMode();
         emit currentViewChanged();
+        prefetchNextView();
         
         qDebug() << "NavigationViewModel initialized with AppStateManager";
     } else {
@@ -64,6 +65,7 @@ bool NavigationViewModel::navigateToView(const QString &viewId)
         emit currentViewChanged();
         
         qDebug() << "Navigated to view:" << viewId;
+        prefetchNextView();
         return true;
     }
     
@@ -222,6 +224,15 @@ void NavigationViewModel::onViewModeChanged(const QString &viewMode)
         m_currentView = viewMode;
         emit currentViewChanged();
         emit viewChanged(viewMode);
+        prefetchNextView();
+    }
+}
+
+void NavigationViewModel::prefetchNextView()
+{
+    // 用户最可能按顺序切到下一个视图，提前让状态管理器生成该视图的数据
+    if (m_appStateManager && !m_availableViews.isEmpty()) {
+        m_appStateManager->prefetchView(getNextView());
     }
 }
 
@@ -1,6 +1,7 @@
 #include "../../include/viewmodels/WeatherViewModel.hpp"
 #include "../../include/models/AppStateManager.hpp"
 #include "../../include/services/WeatherDataService.hpp"
+#include "../../include/services/WeatherDataBus.hpp"
 #include "../../include/commonDataType/WeatherDataModel.hpp"
 #include <QDebug>
 #include <QtCore/qcontainerfwd.h>
@@ -9,11 +10,14 @@
 
 WeatherViewModel::WeatherViewModel(QObject *parent) : QObject(parent)
     ,m_isLoading(false)
+    ,m_weatherModel(new WeatherDataModel(this))
+    ,m_forecastModel(new ForecastListModel(this))
+    ,m_loadGeneration(0)
+    ,m_loadRequest(0)
+    ,m_citySubscription(0)
     ,m_appStateManager(nullptr)
     ,m_weatherDataService(std::make_unique<WeatherDataService>(this))
 {
-    connect(m_weatherDataService.get(), &WeatherDataService::dataLoaded, this, &WeatherViewModel::onDataLoaded);
-    connect(m_weatherDataService.get(), &WeatherDataService::dataLoadError,this, &WeatherViewModel::onDataLoadError);//目前还没实现，等接入API后再实现
     connect(m_weatherDataService.get(), &WeatherDataService::searchResultsReady, this, &WeatherViewModel::onSearchResultsReady);
 }
 
@@ -31,16 +35,21 @@ void WeatherViewModel::initialize(QObject *stateManager)
         connect(m_appStateManager, &AppStateManager::citychanged , this, &WeatherViewModel::onCityChanged);
         // 连接视图模式改变信号到处理函数onViewModeChanged
         connect(m_appStateManager, &AppStateManager::viewmodechanged, this, &WeatherViewModel::onViewModeChanged);
+
+        // 跟随当前城市；状态管理器可能已从启动快照恢复了数据，订阅时会立即回放
+        followCity(m_appStateManager->currentCity().value("cityName").toString());
     }
+    emit recentCitiesModelChanged();
+}
+
+RecentCitiesModel *WeatherViewModel::recentCitiesModel() const
+{
+    return m_appStateManager ? m_appStateManager->recentCitiesModel() : nullptr;
 }
 
 void WeatherViewModel::loadCityWeather(const QString &cityName){
     if(cityName.isEmpty()) return;
-    setLoading(true);
-    clearError();
-
-    // 不使用回调，直接通过信号机制处理数据
-    m_weatherDataService->getCityWeather(cityName, QJSValue());
+    startLoad(cityName);
 }
 
 void WeatherViewModel::loadWeatherData() {
@@ -58,16 +67,65 @@ void WeatherViewModel::loadWeatherData() {
     }
     
     qDebug() << "WeatherViewModel::loadWeatherData() - Loading weather data for city:" << cityName;
+    // 当前天气和预报来自同一个数据包，只需一次请求
+    startLoad(cityName);
+}
+
+void WeatherViewModel::startLoad(const QString &cityName)
+{
+    // 新的加载取代之前的加载：中止旧请求，并让它迟到的结果失效
+    cancelLoad();
+    followCity(cityName);
+    const quint64 generation = m_loadGeneration;
+    m_loadingCity = cityName;
     setLoading(true);
     clearError();
-    
-    // 获取当前天气数据
-    qDebug() << "WeatherViewModel::loadWeatherData() - Calling getCityWeather for:" << cityName;
-    m_weatherDataService->getCityWeather(cityName, QJSValue());
-    
-    // 获取周预报数据
-    qDebug() << "WeatherViewModel::loadWeatherData() - Calling getWeeklyForecast for:" << cityName;
-    m_weatherDataService->getWeeklyForecast(cityName, QJSValue());
+
+    // 数据经数据总线投递到当前城市的订阅，这里只处理加载状态和错误
+    const WeatherRequestId requestId = m_weatherDataService->fetchBundle(cityName,
+        [this, generation](const CityWeatherBundlePtr &bundle, const QString &error) {
+            if (generation != m_loadGeneration) {
+                qDebug() << "Dropping superseded weather response";
+                return;
+            }
+            m_loadRequest = 0;
+            m_loadingCity.clear();
+            if (!bundle) {
+                onDataLoadError(error);
+                return;
+            }
+            setLoading(false);
+        });
+    // 命中缓存时回调已同步执行，不会留下请求
+    if (!m_loadingCity.isEmpty()) {
+        m_loadRequest = requestId;
+    }
+}
+
+void WeatherViewModel::followCity(const QString &cityName)
+{
+    if (cityName.isEmpty() || cityName == m_subscribedCity) {
+        return;
+    }
+
+    // 只订阅正在显示的城市，其他城市的数据不会投递到这里
+    WeatherDataBus *bus = WeatherDataBus::shared();
+    bus->unsubscribe(m_citySubscription);
+    m_subscribedCity = cityName;
+    m_citySubscription = bus->subscribeCurrent(cityName, this, [this, cityName](const CurrentConditions &conditions) {
+        m_weatherCity = cityName;
+        onCurrentConditionsLoaded(conditions);
+    }, true);
+}
+
+void WeatherViewModel::cancelLoad()
+{
+    ++m_loadGeneration;
+    if (m_loadRequest != 0) {
+        m_weatherDataService->cancelRequest(m_loadRequest);
+        m_loadRequest = 0;
+    }
+    m_loadingCity.clear();
 }
 
 // WeatherViewModel 类的成员函数，用于根据查询条件搜索城市信息
@@ -80,6 +138,11 @@ void WeatherViewModel::searchCities(const QString &query , const QJSValue &callb
     }
 }
 
+// 分页搜索城市，结果同样通过searchResultsReady信号发出
+void WeatherViewModel::searchCitiesPage(const QString &query, int offset, int limit, const QJSValue &callback){
+    m_weatherDataService->searchCitiesPage(query, offset, limit, callback);
+}
+
 void WeatherViewModel::addCityToRecent(const QVariantMap &cityData){
     // 如果应用状态管理器存在且城市数据不为空，则将城市数据添加到最近城市列表
     if(m_appStateManager && !cityData.isEmpty()){
@@ -198,9 +261,16 @@ void WeatherViewModel::clearError()
 
 void WeatherViewModel::onCityChanged(const QVariantMap &cityData)
 {
-    m_currentWeatherData = cityData;
+    // 用户已切到别的城市：之前城市的加载作废，改为订阅新城市
+    const QString cityName = cityData.value("cityName").toString();
+    if (!m_loadingCity.isEmpty() && cityName != m_loadingCity) {
+        cancelLoad();
+        setLoading(false);
+    }
+    followCity(cityName);
+    m_currentWeatherData = withWeather(cityData);
     emit currentWeatherDataChanged();
-    emit weatherDataChanged(cityData);
+    emit weatherDataChanged(m_currentWeatherData);
 }
 
 void WeatherViewModel::onViewModeChanged(const QString &viewMode)
@@ -208,31 +278,49 @@ void WeatherViewModel::onViewModeChanged(const QString &viewMode)
     // 视图模式变化时，重新获取当前城市数据
     QVariantMap cityData = getCurrentCityData();
     if (!cityData.isEmpty()) {
-        m_currentWeatherData = cityData;
+        m_currentWeatherData = withWeather(cityData);
         emit currentWeatherDataChanged();
-        emit weatherDataChanged(cityData);
+        emit weatherDataChanged(m_currentWeatherData);
+    }
+}
+
+QVariantMap WeatherViewModel::withWeather(const QVariantMap &cityData) const
+{
+    // 状态管理器给出的是城市记录和视图数据，不含天气字段（后台刷新同一城市时也会发出）
+    // 模型中已有该城市的天气时补上，否则数据未变、模型不通知时界面会一直显示空值
+    QVariantMap result = cityData;
+    if (cityData.value("cityName").toString() != m_weatherCity) {
+        return result;
     }
+    const QVariantMap weather = m_weatherModel->toObject();
+    for (auto it = weather.cbegin(); it != weather.cend(); ++it) {
+        if (!result.contains(it.key())) {
+            result.insert(it.key(), it.value());
+        }
+    }
+    return result;
 }
 
 
-void WeatherViewModel::onDataLoaded(const QVariantMap &data)
+void WeatherViewModel::onCurrentConditionsLoaded(const CurrentConditions &conditions)
 {
-    qDebug() << "WeatherViewModel::onDataLoaded called with data:" << data;
-    qDebug() << "Current m_currentWeatherData before update:" << m_currentWeatherData;
+    qDebug() << "WeatherViewModel::onCurrentConditionsLoaded called for city:" << conditions.cityName;
     
     setLoading(false);
     clearError();
+
+    // 预报列表单独按行比较，委托只更新变化的行
+    m_forecastModel->setForecast(conditions.forecast);
     
-    // 创建WeatherDataModel并更新当前数据
-    auto weatherModel = WeatherDataModel::fromRawData(data, this);
-    if (weatherModel) {
-        m_currentWeatherData = weatherModel->toObject();
-        qDebug() << "New m_currentWeatherData after update:" << m_currentWeatherData;
+    // 就地更新同一个WeatherDataModel，只有变化的属性发出通知
+    // 数据完全没变（例如命中缓存的重复刷新）时不再生成QVariantMap，也不通知整张视图
+    if (m_weatherModel->updateData(conditions)) {
+        m_currentWeatherData = m_weatherModel->toObject();
         emit currentWeatherDataChanged();
         emit weatherDataChanged(m_currentWeatherData);
         qDebug() << "Weather data updated successfully, signals emitted";
     } else {
-        qDebug() << "Failed to create weather model from data";
+        qDebug() << "Weather data unchanged for city:" << conditions.cityName;
     }
 }
 
@@ -0,0 +1,125 @@
+// citybench - 测量城市目录和各运行时索引的常驻内存与查询吞吐量，并与原QMap<QString, QString>布局对比
+// 用法: citybench [轮数，默认100]
+// 常驻内存读取/proc/self/statm（仅Linux），其他平台只输出估算值和查询耗时
+#include "services/CityIndexes.hpp"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 当前进程的常驻内存字节数，无法读取时返回-1
+qint64 residentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+void printResident(const char *label, qint64 before, qint64 after)
+{
+    if (before < 0 || after < 0) {
+        std::printf("%-32s n/a\n", label);
+    } else {
+        std::printf("%-32s %10lld bytes\n", label, static_cast<long long>(after - before));
+    }
+}
+
+// 对每个查询执行rounds轮，返回平均单次耗时（纳秒）
+double timePerCall(qsizetype count, int rounds, const std::function<qsizetype(qsizetype)> &lookup)
+{
+    // 累加查询结果，避免循环被优化掉
+    qsizetype checksum = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int round = 0; round < rounds; ++round) {
+        for (qsizetype i = 0; i < count; ++i) {
+            checksum += lookup(i);
+        }
+    }
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    [[maybe_unused]] volatile qsizetype sink = checksum;
+    return double(elapsedNs) / (double(count) * rounds);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    const int rounds = argc > 1 ? qMax(1, atoi(argv[1])) : 100;
+
+    // 新布局：编译进程序的只读表 + 在其上构建的运行时索引
+    const qint64 beforeIndexes = residentBytes();
+    const auto indexes = std::make_unique<CityIndexes>();
+    const qint64 afterIndexes = residentBytes();
+
+    const CityDirectory &directory = indexes->directory;
+    const qsizetype count = directory.count();
+
+    // 原布局：名称 -> 代码文本的QMap，按同样的数据实际构建
+    const qint64 beforeLegacy = residentBytes();
+    QMap<QString, QString> legacy;
+    for (qsizetype i = 0; i < count; ++i) {
+        legacy.insert(directory.nameAt(i).toString(), directory.codeAt(i));
+    }
+    const qint64 afterLegacy = residentBytes();
+
+    // 查询参数预先生成，不计入查询耗时
+    QStringList names;
+    QStringList bigrams;
+    names.reserve(count);
+    bigrams.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        names.append(directory.nameAt(i).toString());
+        bigrams.append(names.constLast().left(2));
+    }
+
+    std::printf("cities: %lld, rounds: %d\n\n", static_cast<long long>(count), rounds);
+
+    std::printf("resident memory\n");
+    printResident("  tables + indexes (measured)", beforeIndexes, afterIndexes);
+    std::printf("%-32s %10lld bytes\n", "  static tables",
+                static_cast<long long>(CityDirectory::tableFootprint()));
+    std::printf("%-32s %10lld bytes\n", "  search index",
+                static_cast<long long>(indexes->searchIndex.memoryFootprint()));
+    std::printf("%-32s %10lld bytes\n", "  hierarchy",
+                static_cast<long long>(indexes->hierarchy.memoryFootprint()));
+    printResident("  legacy QMap (measured)", beforeLegacy, afterLegacy);
+    std::printf("%-32s %10lld bytes\n", "  legacy QMap (estimated)",
+                static_cast<long long>(CityDirectory::legacyMapFootprint()));
+    std::printf("\n");
+
+    std::printf("lookup time per call\n");
+    std::printf("  name (directory)            %8.1f ns\n", timePerCall(count, rounds, [&](qsizetype i) {
+        return directory.indexOf(names.at(i));
+    }));
+    std::printf("  name (legacy QMap)          %8.1f ns\n", timePerCall(count, rounds, [&](qsizetype i) {
+        return legacy.value(names.at(i)).size();
+    }));
+    std::printf("  code (hierarchy)            %8.1f ns\n", timePerCall(count, rounds, [&](qsizetype i) {
+        return qsizetype(indexes->hierarchy.nodeForCode(directory.numericCodeAt(i)));
+    }));
+    std::printf("  two-character substring     %8.1f ns\n", timePerCall(count, rounds, [&](qsizetype i) {
+        return indexes->searchIndex.findSubstring(bigrams.at(i)).size();
+    }));
+    return 0;
+}
@@ -0,0 +1,408 @@
+// citycodegen - 把城市代码JSON编译成排序好的只读C++表
+// 用法: citycodegen <citycode.json> <citypinyin.json> <cityalias.json> <output.cpp>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+struct CityRecord {
+    QString name;
+    quint32 code;
+    quint32 node;  // 在层级表中的下标
+};
+
+// 层级表中的一个节点（省、市、区县），包括没有城市代码的省份
+struct NodeRecord {
+    QString name;
+    quint32 code;       // 没有代码时为0
+    qint64 parentId;    // JSON中的pid
+    quint32 parent;     // 父节点下标
+    quint32 nameOffset;
+    QList<quint32> children;
+};
+
+// 没有父节点/不在城市表中
+constexpr quint32 kNoIndex = 0xFFFFFFFFu;
+// 表中16位下标列的"无"，与CityDirectoryData::kNoNode一致
+constexpr quint32 kNoNode = 0xFFFFu;
+
+// 拼音键：全拼或首字母，指向排序后的城市下标
+struct PinyinKeyRecord {
+    QByteArray text;
+    quint32 entryIndex;
+    quint8 kind;
+};
+
+enum PinyinKeyKind : quint8 {
+    FullPinyin = 0,
+    Initials = 1
+};
+
+QJsonDocument readJson(const char *path, QString *error)
+{
+    QFile file(QString::fromLocal8Bit(path));
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = QStringLiteral("cannot open %1").arg(QString::fromLocal8Bit(path));
+        return QJsonDocument();
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        *error = QStringLiteral("invalid JSON in %1: %2").arg(QString::fromLocal8Bit(path), parseError.errorString());
+        return QJsonDocument();
+    }
+    return doc;
+}
+
+// 城市名称各读法的拼音音节：整名覆盖表优先（处理多音字，多种通行读法用"|"分隔），否则逐字查表
+QList<QList<QByteArray>> readingsFor(const QString &name, const QJsonObject &chars, const QJsonObject &names)
+{
+    QList<QList<QByteArray>> readings;
+    const QJsonValue override = names.value(name);
+    if (override.isString()) {
+        for (const QString &reading : override.toString().split('|', Qt::SkipEmptyParts)) {
+            QList<QByteArray> syllables;
+            for (const QString &syllable : reading.split(' ', Qt::SkipEmptyParts)) {
+                syllables.append(syllable.toLatin1());
+            }
+            if (!syllables.isEmpty()) {
+                readings.append(syllables);
+            }
+        }
+        return readings;
+    }
+
+    QList<QByteArray> syllables;
+    for (const QChar ch : name) {
+        const QString syllable = chars.value(QString(ch)).toString();
+        if (syllable.isEmpty()) {
+            return {};
+        }
+        syllables.append(syllable.toLatin1());
+    }
+    readings.append(syllables);
+    return readings;
+}
+
+// 别名规范化：只保留字母并转为小写（"Xi'an" -> "xian"，"Hong Kong" -> "hongkong"）
+// 与运行时CityAliasIndex::normalize保持一致
+QByteArray normalizeAlias(const QString &alias)
+{
+    QByteArray key;
+    for (const QChar ch : alias) {
+        const char16_t unit = ch.unicode();
+        if (unit >= u'a' && unit <= u'z') {
+            key.append(char(unit));
+        } else if (unit >= u'A' && unit <= u'Z') {
+            key.append(char(unit - u'A' + u'a'));
+        }
+    }
+    return key;
+}
+
+// 以字符串字面量分段输出ASCII文本（拼音只含小写字母，无需转义）
+void appendStringLiteral(QByteArray &out, const QByteArray &text)
+{
+    if (text.isEmpty()) {
+        out += "\n    \"\"";
+    }
+    for (qsizetype i = 0; i < text.size(); i += 96) {
+        out += "\n    \"" + text.mid(i, 96) + "\"";
+    }
+    out += "\n";
+}
+
+// 输出一列无符号整数（每行12个），kNoIndex按列宽写成kNoNode；保证数组非空
+void appendColumn(QByteArray &out, const char *type, const char *name, const QList<quint32> &values)
+{
+    out += QByteArray("const ") + type + " " + name + "[] = {";
+    for (qsizetype i = 0; i < values.size(); ++i) {
+        if (i % 12 == 0) {
+            out += "\n    ";
+        }
+        out += QByteArray::number(values.at(i) == kNoIndex ? kNoNode : values.at(i)) + "u, ";
+    }
+    out += "\n    0u\n};\n\n";
+}
+
+// 以UTF-16码元数组的形式输出，避免不同编译器对长字符串字面量和源码编码的限制
+void appendCharArray(QByteArray &out, const QString &text)
+{
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        if (i % 12 == 0) {
+            out += "\n    ";
+        }
+        out += "0x" + QByteArray::number(uint(text.at(i).unicode()), 16).rightJustified(4, '0') + ", ";
+    }
+    out += "\n    0x0000\n";
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 5) {
+        std::fprintf(stderr, "usage: citycodegen <citycode.json> <citypinyin.json> <cityalias.json> <output.cpp>\n");
+        return 1;
+    }
+
+    QString error;
+    const QJsonDocument doc = readJson(argv[1], &error);
+    if (!error.isEmpty() || !doc.isArray()) {
+        std::fprintf(stderr, "citycodegen: %s\n", error.isEmpty() ? "city list must be a JSON array" : qPrintable(error));
+        return 1;
+    }
+    const QJsonDocument pinyinDoc = readJson(argv[2], &error);
+    if (!error.isEmpty() || !pinyinDoc.isObject()) {
+        std::fprintf(stderr, "citycodegen: %s\n", error.isEmpty() ? "pinyin table must be a JSON object" : qPrintable(error));
+        return 1;
+    }
+    const QJsonDocument aliasDoc = readJson(argv[3], &error);
+    if (!error.isEmpty() || !aliasDoc.isObject()) {
+        std::fprintf(stderr, "citycodegen: %s\n", error.isEmpty() ? "alias table must be a JSON object" : qPrintable(error));
+        return 1;
+    }
+    const QJsonObject pinyinChars = pinyinDoc.object().value("chars").toObject();
+    const QJsonObject pinyinNames = pinyinDoc.object().value("names").toObject();
+
+    // 所有有名称的记录都进入层级表（按文件顺序）；只有同时有名称和代码的才进入按名称排序的城市表
+    QList<NodeRecord> nodes;
+    QHash<qint64, quint32> nodeById;
+    QList<CityRecord> records;
+    const QJsonArray cities = doc.array();
+    for (const QJsonValue &value : cities) {
+        const QJsonObject city = value.toObject();
+        const QString name = city.value("city_name").toString();
+        const QString codeText = city.value("city_code").toString();
+        if (name.isEmpty() || name.size() > 0xFFFF) {
+            continue;
+        }
+
+        quint32 code = 0;
+        if (!codeText.isEmpty()) {
+            bool ok = false;
+            code = codeText.toUInt(&ok);
+            if (!ok || codeText.size() != 9) {
+                std::fprintf(stderr, "citycodegen: skipping invalid code for %s\n", qPrintable(name));
+                code = 0;
+            }
+        }
+
+        const quint32 nodeIndex = quint32(nodes.size());
+        nodeById.insert(qint64(city.value("id").toDouble()), nodeIndex);
+        nodes.append({name, code, qint64(city.value("pid").toDouble()), kNoIndex, 0, {}});
+        if (code != 0) {
+            records.append({name, code, nodeIndex});
+        }
+    }
+
+    // 连接父子关系；pid指向不存在的记录时当作顶层节点
+    for (quint32 i = 0; i < quint32(nodes.size()); ++i) {
+        NodeRecord &node = nodes[i];
+        const auto parent = nodeById.constFind(node.parentId);
+        if (node.parentId != 0 && parent != nodeById.constEnd() && parent.value() != i) {
+            node.parent = parent.value();
+            nodes[parent.value()].children.append(i);
+        } else if (node.parentId != 0) {
+            std::fprintf(stderr, "citycodegen: %s has unknown parent %lld\n",
+                         qPrintable(node.name), static_cast<long long>(node.parentId));
+        }
+    }
+
+    // 城市表和层级表的下标按16位存放（kNoNode保留作"无"）
+    if (nodes.size() >= qsizetype(kNoNode)) {
+        std::fprintf(stderr, "citycodegen: %lld nodes do not fit 16-bit indexes\n", static_cast<long long>(nodes.size()));
+        return 1;
+    }
+
+    // 稳定排序：同名城市保持文件中的先后顺序
+    std::stable_sort(records.begin(), records.end(), [](const CityRecord &a, const CityRecord &b) {
+        return QString::compare(a.name, b.name) < 0;
+    });
+
+    // 城市表按列输出：二分查找只读名称列，代码和节点列在命中后才读取
+    QString names;
+    QList<quint32> entryNameOffsets;
+    QList<quint32> entryNameLengths;
+    QList<quint32> entryCodes;
+    QList<quint32> entryNodes;
+    QList<quint32> entryOfNode(nodes.size(), kNoIndex);
+    for (qsizetype i = 0; i < records.size(); ++i) {
+        const CityRecord &record = records.at(i);
+        entryNameOffsets.append(quint32(names.size()));
+        entryNameLengths.append(quint32(record.name.size()));
+        entryCodes.append(record.code);
+        entryNodes.append(record.node);
+        nodes[record.node].nameOffset = quint32(names.size());
+        entryOfNode[record.node] = quint32(i);
+        names += record.name;
+    }
+    // 没有代码的节点（省份等）的名称接在后面
+    for (quint32 i = 0; i < quint32(nodes.size()); ++i) {
+        if (entryOfNode.at(i) == kNoIndex) {
+            nodes[i].nameOffset = quint32(names.size());
+            names += nodes.at(i).name;
+        }
+    }
+
+    // 层级表同样按列输出：子节点下标集中存放在kChildren中，每个节点记录自己的区间
+    QList<quint32> nodeNameOffsets;
+    QList<quint32> nodeNameLengths;
+    QList<quint32> nodeCodes;
+    QList<quint32> nodeParents;
+    QList<quint32> nodeEntries;
+    QList<quint32> nodeChildOffsets;
+    QList<quint32> nodeChildCounts;
+    QList<quint32> children;
+    for (quint32 i = 0; i < quint32(nodes.size()); ++i) {
+        const NodeRecord &node = nodes.at(i);
+        nodeNameOffsets.append(node.nameOffset);
+        nodeNameLengths.append(quint32(node.name.size()));
+        nodeCodes.append(node.code);
+        nodeParents.append(node.parent);
+        nodeEntries.append(entryOfNode.at(i));
+        nodeChildOffsets.append(quint32(children.size()));
+        nodeChildCounts.append(quint32(node.children.size()));
+        children.append(node.children);
+    }
+
+    // 每个城市生成全拼和首字母两个键，按键排序后相同前缀的键连续存放（展平的前缀树）
+    QList<PinyinKeyRecord> pinyinKeys;
+    // 别名候选：全拼，以及以"市"结尾的城市去掉末尾"shi"后的全拼（nanchangshi -> nanchang）；对应多个城市的候选稍后丢弃
+    QHash<QByteArray, QList<quint32>> pinyinAliases;
+    for (qsizetype i = 0; i < records.size(); ++i) {
+        const QList<QList<QByteArray>> readings = readingsFor(records.at(i).name, pinyinChars, pinyinNames);
+        if (readings.isEmpty()) {
+            std::fprintf(stderr, "citycodegen: no pinyin for %s\n", qPrintable(records.at(i).name));
+            continue;
+        }
+        // 有多种读法时每种读法都生成键，按任一读法输入都能找到
+        for (const QList<QByteArray> &syllables : readings) {
+            QByteArray full;
+            QByteArray initials;
+            for (const QByteArray &syllable : syllables) {
+                full += syllable;
+                initials += syllable.left(1);
+            }
+            if (full.size() > 0xFF) {
+                continue;
+            }
+            pinyinKeys.append({full, quint32(i), FullPinyin});
+            pinyinKeys.append({initials, quint32(i), Initials});
+
+            pinyinAliases[full].append(quint32(i));
+            if (records.at(i).name.endsWith(QChar(u'市')) && syllables.size() > 2) {
+                pinyinAliases[full.chopped(syllables.constLast().size())].append(quint32(i));
+            }
+        }
+    }
+    std::stable_sort(pinyinKeys.begin(), pinyinKeys.end(), [](const PinyinKeyRecord &a, const PinyinKeyRecord &b) {
+        return a.text < b.text;
+    });
+
+    QByteArray pinyinText;
+    QByteArray pinyinEntries;
+    for (const PinyinKeyRecord &key : pinyinKeys) {
+        pinyinEntries += "    { " + QByteArray::number(qsizetype(pinyinText.size())) + "u, "
+                         + QByteArray::number(key.entryIndex) + "u, "
+                         + QByteArray::number(qsizetype(key.text.size())) + "u, "
+                         + QByteArray::number(key.kind) + "u },\n";
+        pinyinText += key.text;
+    }
+
+    // 别名表：手工维护的英文名/旧式拼写优先，其次是只对应一个城市的全拼
+    QHash<QByteArray, quint32> aliases;
+    for (auto it = pinyinAliases.constBegin(); it != pinyinAliases.constEnd(); ++it) {
+        if (it.value().size() == 1) {
+            aliases.insert(it.key(), it.value().constFirst());
+        }
+    }
+    const QJsonObject aliasObject = aliasDoc.object();
+    for (auto it = aliasObject.constBegin(); it != aliasObject.constEnd(); ++it) {
+        // 同名城市取文件中靠前的一条（稳定排序后即第一条）
+        const auto entry = std::lower_bound(records.cbegin(), records.cend(), it.key(), [](const CityRecord &record, const QString &name) {
+            return QString::compare(record.name, name) < 0;
+        });
+        if (entry == records.cend() || entry->name != it.key()) {
+            std::fprintf(stderr, "citycodegen: alias target %s not found\n", qPrintable(it.key()));
+            continue;
+        }
+        for (const QJsonValue &alias : it.value().toArray()) {
+            const QByteArray key = normalizeAlias(alias.toString());
+            if (!key.isEmpty() && key.size() <= 0xFF) {
+                aliases.insert(key, quint32(entry - records.cbegin()));
+            }
+        }
+    }
+    QList<QByteArray> aliasKeys = aliases.keys();
+    std::sort(aliasKeys.begin(), aliasKeys.end());
+
+    QByteArray aliasText;
+    QByteArray aliasEntries;
+    for (const QByteArray &key : std::as_const(aliasKeys)) {
+        aliasEntries += "    { " + QByteArray::number(qsizetype(aliasText.size())) + "u, "
+                        + QByteArray::number(aliases.value(key)) + "u, "
+                        + QByteArray::number(qsizetype(key.size())) + "u },\n";
+        aliasText += key;
+    }
+
+    QByteArray out;
+    out += "// 由 citycodegen 根据 " + QFileInfo(QString::fromLocal8Bit(argv[1])).fileName().toUtf8() + "、"
+           + QFileInfo(QString::fromLocal8Bit(argv[2])).fileName().toUtf8() + " 和 "
+           + QFileInfo(QString::fromLocal8Bit(argv[3])).fileName().toUtf8() + " 生成，请勿手动修改\n";
+    out += "#include \"services/CityDirectoryData.hpp\"\n\n";
+    out += "namespace CityDirectoryData {\n\n";
+    appendColumn(out, "quint32", "kEntryNameOffsets", entryNameOffsets);
+    appendColumn(out, "quint16", "kEntryNameLengths", entryNameLengths);
+    appendColumn(out, "quint32", "kEntryCodes", entryCodes);
+    appendColumn(out, "quint16", "kEntryNodes", entryNodes);
+    out += "const quint32 kEntryCount = " + QByteArray::number(qsizetype(records.size())) + "u;\n\n";
+    out += "const char16_t kNames[] = {";
+    appendCharArray(out, names);
+    out += "};\n\n";
+    out += "const quint32 kNamesLength = " + QByteArray::number(qsizetype(names.size())) + "u;\n\n";
+    appendColumn(out, "quint32", "kNodeNameOffsets", nodeNameOffsets);
+    appendColumn(out, "quint16", "kNodeNameLengths", nodeNameLengths);
+    appendColumn(out, "quint32", "kNodeCodes", nodeCodes);
+    appendColumn(out, "quint16", "kNodeParents", nodeParents);
+    appendColumn(out, "quint16", "kNodeEntries", nodeEntries);
+    appendColumn(out, "quint16", "kNodeChildOffsets", nodeChildOffsets);
+    appendColumn(out, "quint16", "kNodeChildCounts", nodeChildCounts);
+    out += "const quint32 kNodeCount = " + QByteArray::number(qsizetype(nodes.size())) + "u;\n\n";
+    appendColumn(out, "quint16", "kChildren", children);
+    out += "const PinyinKey kPinyinKeys[] = {\n" + pinyinEntries + "};\n\n";
+    out += "const quint32 kPinyinKeyCount = " + QByteArray::number(qsizetype(pinyinKeys.size())) + "u;\n\n";
+    out += "const char kPinyinText[] =";
+    appendStringLiteral(out, pinyinText);
+    out += "    ;\n\n";
+    // 保证数组非空
+    out += "const Alias kAliases[] = {\n" + aliasEntries + "    { 0u, 0u, 0u }\n};\n\n";
+    out += "const quint32 kAliasCount = " + QByteArray::number(qsizetype(aliasKeys.size())) + "u;\n\n";
+    out += "const char kAliasText[] =";
+    appendStringLiteral(out, aliasText);
+    out += "    ;\n\n";
+    out += "}\n";
+
+    QFile output(QString::fromLocal8Bit(argv[4]));
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::fprintf(stderr, "citycodegen: cannot write %s\n", argv[4]);
+        return 1;
+    }
+    output.write(out);
+
+    std::printf("citycodegen: %lld cities, %lld nodes, %lld name units, %lld pinyin keys, %lld aliases\n",
+                static_cast<long long>(records.size()), static_cast<long long>(nodes.size()),
+                static_cast<long long>(names.size()), static_cast<long long>(pinyinKeys.size()),
+                static_cast<long long>(aliasKeys.size()));
+    return 0;
+}